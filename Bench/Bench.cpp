@@ -0,0 +1,230 @@
+﻿#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "LargePageBuffer.h"
+#include "Numa.h"
+#include "Profiler.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: Bench [options]\n"
+            << "  --depth <n>     Search depth of every position (default: 7)\n"
+            << "  --multipv <n>   Also runs the bench with n lines and reports the overhead against a single line\n"
+            << "  --threads <n>   Search threads (default: 1)\n"
+            << "  --hash <mb>     Transposition table size (default: 16)\n"
+            << "  --disable <t>   Turns off a selective search technique, may be repeated: nmp, lmr, futility, razoring, checks\n"
+            << "  --ablation      Also runs the bench with each technique turned off, then with all of them turned off\n"
+            << "  --large-pages <0|1>  Backs the transposition table with huge pages when available (default: 1)\n"
+            << "  --bind <0|1>    Spreads the helper threads over the NUMA nodes (default: 1)\n"
+            << "  --memory        Also runs the bench without huge pages and thread binding and reports the speed difference\n"
+            << "  --perft <n>     Only checks the move generation: counts the move tree of reference positions to depth n (at most 5)\n"
+            << "                  and fails if a count differs from the known one\n";
+    }
+
+    using OptionMember = bool SearchOptions::*;
+
+    constexpr std::array<std::pair<std::string_view, OptionMember>, 5> Techniques = { {
+        { "nmp", &SearchOptions::nullMovePruning },
+        { "lmr", &SearchOptions::lateMoveReductions },
+        { "futility", &SearchOptions::futilityPruning },
+        { "razoring", &SearchOptions::razoring },
+        { "checks", &SearchOptions::checkExtensions }
+    } };
+
+    bool DisableTechnique(SearchOptions& options, const std::string_view name)
+    {
+        for (const auto& [techniqueName, member] : Techniques)
+        {
+            if (techniqueName != name)
+                continue;
+            options.*member = false;
+            return true;
+        }
+        return false;
+    }
+
+    void PrintPosition(const BenchPositionResult& result)
+    {
+        std::cout << std::left << std::setw(76) << result.fen << std::right
+            << " " << std::setw(6) << result.bestMove.ToUci()
+            << " " << std::setw(7) << result.score
+            << " " << std::setw(11) << result.nodes << " nodes"
+            << " " << std::setw(7) << result.milliseconds << " ms\n";
+    }
+
+    void PrintTotal(const BenchResult& result)
+    {
+        std::cout << "Total: " << result.nodes << " nodes, " << result.milliseconds << " ms, "
+            << result.GetNodesPerSecond() << " nodes/s\n\n";
+    }
+
+    void PrintMemory(const BenchResult& result)
+    {
+        std::cout << "Hash: " << LargePageBuffer::GetName(result.allocationMode) << ", helper threads bound to "
+            << result.boundNodeCount << " of " << Numa::GetNodeCount() << " NUMA node(s)\n";
+    }
+
+    void PrintIterations(const BenchResult& result)
+    {
+        std::cout << "Depth        Nodes    Time  Branching\n";
+        for (size_t i = 0; i < result.iterations.size(); i++)
+        {
+            const BenchIteration& iteration = result.iterations[i];
+            std::cout << std::setw(5) << i + 1 << " " << std::setw(12) << iteration.nodes << " " << std::setw(5) << iteration.milliseconds << " ms";
+            if (i > 0 && result.iterations[i - 1].nodes)
+                std::cout << std::fixed << std::setprecision(2) << std::setw(11)
+                    << static_cast<double>(iteration.nodes) / static_cast<double>(result.iterations[i - 1].nodes);
+            std::cout << '\n';
+        }
+        std::cout << std::fixed << std::setprecision(2) << "Effective branching factor: " << result.GetEffectiveBranchingFactor() << "\n\n";
+    }
+
+    void PrintPerft(const PerftPositionResult& result)
+    {
+        std::cout << std::left << std::setw(76) << result.fen << std::right
+            << " depth " << result.depth
+            << " " << std::setw(11) << result.nodes << " nodes"
+            << " " << std::setw(7) << result.milliseconds << " ms"
+            << (result.IsCorrect() ? "  ok" : "  FAILED, expected " + std::to_string(result.expectedNodes)) << '\n';
+    }
+
+    double GetIncrease(const uint64_t value, const uint64_t reference)
+    {
+        return reference ? (static_cast<double>(value) / static_cast<double>(reference) - 1.0) * 100.0 : 0.0;
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    BenchSettings settings;
+    int multiPv = 1;
+    bool ablation = false;
+    bool memoryComparison = false;
+    int perftDepth = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view option = argv[i];
+        if (option == "--ablation" || option == "--memory")
+        {
+            (option == "--ablation" ? ablation : memoryComparison) = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        const std::string_view argument = argv[++i];
+        const int value = std::atoi(argument.data());
+        if (option == "--depth")
+            settings.depth = value;
+        else if (option == "--multipv")
+            multiPv = std::max(value, 1);
+        else if (option == "--threads")
+            settings.threadCount = static_cast<size_t>(std::max(value, 1));
+        else if (option == "--hash")
+            settings.hashMegabytes = static_cast<size_t>(std::max(value, 1));
+        else if (option == "--large-pages")
+            settings.largePages = value != 0;
+        else if (option == "--bind")
+            settings.threadBinding = value != 0;
+        else if (option == "--perft")
+            perftDepth = std::max(value, 1);
+        else if (option != "--disable" || !DisableTechnique(settings.options, argument))
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (perftDepth > 0)
+    {
+        const bool isCorrect = Benchmark::RunPerft(perftDepth, PrintPerft);
+        std::cout << (isCorrect ? "Perft: all counts match\n" : "Perft: move generation FAILED\n");
+        return isCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::cout << "Depth " << settings.depth << ", " << settings.threadCount << " thread(s), " << settings.hashMegabytes << " MB, profiler "
+        << (CHESSAI_PROFILE ? "compiled in" : "disabled") << '\n';
+    for (const auto& [name, member] : Techniques)
+        std::cout << name << (settings.options.*member ? " on " : " off ");
+    std::cout << "\n\n";
+
+    const BenchResult singlePv = Benchmark::Run(settings, PrintPosition);
+    PrintMemory(singlePv);
+    PrintTotal(singlePv);
+    PrintIterations(singlePv);
+
+    if (memoryComparison)
+    {
+        BenchSettings plainSettings = settings;
+        plainSettings.largePages = false;
+        plainSettings.threadBinding = false;
+        const BenchResult plain = Benchmark::Run(plainSettings);
+        PrintMemory(plain);
+        PrintTotal(plain);
+
+        std::cout << std::fixed << std::setprecision(1) << "Speed with the memory options: " << std::showpos
+            << GetIncrease(singlePv.GetNodesPerSecond(), plain.GetNodesPerSecond()) << "% nodes/s" << std::noshowpos << "\n\n";
+    }
+
+    if (multiPv > 1)
+    {
+        settings.multiPv = multiPv;
+        std::cout << "MultiPV " << multiPv << '\n';
+        const BenchResult result = Benchmark::Run(settings, PrintPosition);
+        PrintTotal(result);
+
+        std::cout << std::fixed << std::setprecision(1) << "MultiPV " << multiPv << " overhead: "
+            << std::showpos << GetIncrease(result.nodes, singlePv.nodes) << "% nodes, "
+            << GetIncrease(static_cast<uint64_t>(result.milliseconds), static_cast<uint64_t>(singlePv.milliseconds)) << "% time\n"
+            << std::noshowpos << '\n';
+        settings.multiPv = 1;
+    }
+
+    if (ablation)
+    {
+        // Each variant only changes the options, the positions and the depth stay the same
+        std::vector<std::pair<std::string, SearchOptions>> variants;
+        for (const auto& [name, member] : Techniques)
+        {
+            if (!(settings.options.*member))
+                continue;
+            SearchOptions options = settings.options;
+            options.*member = false;
+            variants.emplace_back("without " + std::string(name), options);
+        }
+        variants.emplace_back("all off", SearchOptions{ false, false, false, false, false });
+
+        std::cout << std::left << std::setw(16) << "Variant" << std::right << std::setw(13) << "Nodes" << std::setw(10) << "Time"
+            << std::setw(10) << "Nodes" << std::setw(10) << "Time" << std::setw(6) << "EBF" << '\n'
+            << std::left << std::setw(16) << "baseline" << std::right << std::setw(13) << singlePv.nodes
+            << std::setw(7) << singlePv.milliseconds << " ms" << std::setw(21) << ""
+            << std::fixed << std::setprecision(2) << std::setw(6) << singlePv.GetEffectiveBranchingFactor() << '\n';
+        for (const auto& [name, options] : variants)
+        {
+            settings.options = options;
+            const BenchResult result = Benchmark::Run(settings);
+            std::cout << std::left << std::setw(16) << name << std::right << std::setw(13) << result.nodes
+                << std::setw(7) << result.milliseconds << " ms" << std::fixed << std::setprecision(1) << std::showpos
+                << std::setw(9) << GetIncrease(result.nodes, singlePv.nodes) << '%'
+                << std::setw(9) << GetIncrease(static_cast<uint64_t>(result.milliseconds), static_cast<uint64_t>(singlePv.milliseconds)) << '%'
+                << std::noshowpos << std::setprecision(2) << std::setw(6) << result.GetEffectiveBranchingFactor() << '\n';
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
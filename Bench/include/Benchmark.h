@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "Search.h"
+
+struct BenchSettings
+{
+    int depth = 7;
+    int multiPv = 1;
+    size_t threadCount = 1;
+    size_t hashMegabytes = 16;
+    SearchOptions options;
+    bool largePages = true;
+    bool threadBinding = true;
+};
+
+// Totals when an iteration of the iterative deepening completes, counted from the start of the search
+struct BenchIteration
+{
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+};
+
+struct BenchPositionResult
+{
+    std::string_view fen;
+    Move bestMove;
+    int score = 0;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    // Indexed by depth - 1
+    std::vector<BenchIteration> iterations;
+};
+
+struct BenchResult
+{
+    std::vector<BenchPositionResult> positions;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    // Sums over the positions, indexed by depth - 1: the time to depth and the nodes needed to reach each depth
+    std::vector<BenchIteration> iterations;
+    // Memory placement actually obtained
+    AllocationMode allocationMode = AllocationMode::None;
+    size_t boundNodeCount = 0;
+
+    [[nodiscard]] uint64_t GetNodesPerSecond() const { return nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(milliseconds, 1)); }
+
+    // Growth of the nodes from one depth to the next, averaged geometrically from depth 1 to the deepest one
+    [[nodiscard]] double GetEffectiveBranchingFactor() const
+    {
+        if (iterations.size() < 2 || iterations.front().nodes == 0)
+            return 0.0;
+        const double growth = static_cast<double>(iterations.back().nodes) / static_cast<double>(iterations.front().nodes);
+        return std::pow(growth, 1.0 / static_cast<double>(iterations.size() - 1));
+    }
+};
+
+struct PerftPositionResult
+{
+    std::string_view fen;
+    int depth = 0;
+    uint64_t nodes = 0;
+    uint64_t expectedNodes = 0;
+    int64_t milliseconds = 0;
+
+    [[nodiscard]] bool IsCorrect() const { return nodes == expectedNodes; }
+};
+
+// Searches a fixed set of positions to a fixed depth, so that runs can be compared node for node
+class Benchmark
+{
+public:
+    static constexpr std::array<std::string_view, 10> Positions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r1bq1rk1/ppp2ppp/2np1n2/2b1p3/2B1P3/2NP1N2/PPP2PPP/R1BQ1RK1 w - - 0 7",
+        "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",
+        "6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 1"
+    };
+
+    // Reference leaf counts of the first bench positions, indexed by depth - 1. The last position has an en passant
+    // square no pawn can have crossed, which must be ignored rather than generate a capture.
+    struct PerftReference
+    {
+        std::string_view fen;
+        std::array<uint64_t, 5> nodes;
+    };
+
+    static constexpr std::array<PerftReference, 7> PerftPositions = { {
+        { Positions[0], { 20, 400, 8902, 197281, 4865609 } },
+        { Positions[1], { 48, 2039, 97862, 4085603, 193690690 } },
+        { Positions[2], { 14, 191, 2812, 43238, 674624 } },
+        { Positions[3], { 6, 264, 9467, 422333, 15833292 } },
+        { Positions[4], { 44, 1486, 62379, 2103487, 89941194 } },
+        { Positions[5], { 46, 2079, 89890, 3894594, 164075551 } },
+        { "4k3/8/8/8/8/8/3P4/4K3 w - e3", { 6, 30, 220, 1492, 11602 } }
+    } };
+
+    Benchmark() = delete;
+
+    // onPosition is called after each position is searched
+    static BenchResult Run(const BenchSettings& settings, const std::function<void(const BenchPositionResult&)>& onPosition = {});
+
+    // Counts the leaves of the legal move tree of every perft position and compares them to the reference counts.
+    // Returns false if any count differs.
+    static bool RunPerft(int depth, const std::function<void(const PerftPositionResult&)>& onPosition = {});
+    [[nodiscard]] static uint64_t Perft(Position& position, int depth);
+};
@@ -0,0 +1,100 @@
+﻿#include "Benchmark.h"
+
+#include <chrono>
+
+BenchResult Benchmark::Run(const BenchSettings& settings, const std::function<void(const BenchPositionResult&)>& onPosition)
+{
+    Search search(settings.hashMegabytes, settings.threadCount);
+    search.options = settings.options;
+    if (!settings.largePages)
+        search.SetLargePages(false);
+    if (!settings.threadBinding)
+        search.SetThreadBinding(false);
+
+    std::vector<BenchIteration> iterations;
+    search.onIteration = [&iterations](const SearchIteration& iteration)
+    {
+        iterations.resize(std::max<size_t>(iterations.size(), static_cast<size_t>(iteration.depth)));
+        iterations[static_cast<size_t>(iteration.depth - 1)] = { iteration.nodes, iteration.milliseconds };
+    };
+
+    SearchLimits limits;
+    limits.depth = settings.depth;
+    limits.multiPv = settings.multiPv;
+
+    BenchResult result;
+    result.allocationMode = search.GetAllocationMode();
+    result.boundNodeCount = search.GetBoundNodeCount();
+    for (const std::string_view fen : Positions)
+    {
+        Position position;
+        position.SetFen(fen);
+
+        // Every position starts from empty tables, so that the results do not depend on the order of the positions
+        search.Clear();
+        iterations.clear();
+        const SearchResult searchResult = search.Run(position, limits);
+
+        BenchPositionResult& positionResult = result.positions.emplace_back();
+        positionResult.fen = fen;
+        positionResult.bestMove = searchResult.bestMove;
+        positionResult.score = searchResult.score;
+        positionResult.nodes = searchResult.nodes;
+        positionResult.milliseconds = searchResult.milliseconds;
+        positionResult.iterations = iterations;
+
+        result.nodes += searchResult.nodes;
+        result.milliseconds += searchResult.milliseconds;
+        result.iterations.resize(std::max(result.iterations.size(), iterations.size()));
+        for (size_t i = 0; i < iterations.size(); i++)
+        {
+            result.iterations[i].nodes += iterations[i].nodes;
+            result.iterations[i].milliseconds += iterations[i].milliseconds;
+        }
+        if (onPosition)
+            onPosition(positionResult);
+    }
+
+    return result;
+}
+
+bool Benchmark::RunPerft(const int depth, const std::function<void(const PerftPositionResult&)>& onPosition)
+{
+    bool isCorrect = true;
+    for (const PerftReference& reference : PerftPositions)
+    {
+        Position position;
+        position.SetFen(reference.fen);
+
+        PerftPositionResult result;
+        result.fen = reference.fen;
+        result.depth = std::clamp(depth, 1, static_cast<int>(reference.nodes.size()));
+        result.expectedNodes = reference.nodes[static_cast<size_t>(result.depth - 1)];
+
+        const auto startTime = std::chrono::steady_clock::now();
+        result.nodes = Perft(position, result.depth);
+        result.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        isCorrect = isCorrect && result.IsCorrect();
+        if (onPosition)
+            onPosition(result);
+    }
+    return isCorrect;
+}
+
+uint64_t Benchmark::Perft(Position& position, const int depth)
+{
+    MoveList moves;
+    position.GenerateMoves(moves);
+
+    uint64_t nodes = 0;
+    for (const Move move : moves)
+    {
+        UndoInfo undo;
+        if (!position.MakeMove(move, undo))
+            continue;
+        nodes += depth > 1 ? Perft(position, depth - 1) : 1;
+        position.UnmakeMove(move, undo);
+    }
+    return nodes;
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "Position.h"
+#include "Search.h"
+#include "TripleBuffer.h"
+
+struct AnalysisLine
+{
+    static constexpr size_t MaxPvLength = 16;
+
+    int score = 0;
+    std::array<Move, MaxPvLength> pv{};
+    uint8_t pvLength = 0;
+};
+
+struct AnalysisSnapshot
+{
+    static constexpr size_t MaxLines = 5;
+
+    // Generation of the position this analysis belongs to
+    uint32_t generation = 0;
+    bool isWhiteToMove = true;
+    int depth = 0;
+    int selectiveDepth = 0;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    int hashfull = 0;
+    // Best line first
+    std::array<AnalysisLine, MaxLines> lines{};
+    uint8_t lineCount = 0;
+};
+
+// Continuously searches the last position it was given on a background thread. The GUI thread hands positions over
+// and reads results through triple buffers, so it never waits for the engine.
+class AnalysisWorker
+{
+public:
+    explicit AnalysisWorker(size_t threadCount, size_t hashMegabytes = 64);
+    ~AnalysisWorker();
+
+    AnalysisWorker(const AnalysisWorker&) = delete;
+    AnalysisWorker& operator=(const AnalysisWorker&) = delete;
+
+    // GUI thread only: restarts the search on the new position
+    void SetPosition(const Position& position);
+    void SetEnabled(bool enabled);
+    // Number of best moves analysed, each with its own line
+    void SetLineCount(int count);
+    [[nodiscard]] uint32_t GetPositionGeneration() const { return positionGeneration; }
+    // Fixed once constructed, so safe to read from the GUI thread
+    [[nodiscard]] AllocationMode GetHashAllocationMode() const { return search.GetAllocationMode(); }
+    [[nodiscard]] size_t GetHashSizeInBytes() const { return search.GetHashSizeInBytes(); }
+
+    // GUI thread only: latest published analysis, possibly of a previous position
+    [[nodiscard]] const AnalysisSnapshot& GetSnapshot();
+
+private:
+    struct PositionRequest
+    {
+        Position position;
+        uint32_t generation = 0;
+    };
+
+    void Loop();
+    void Signal();
+    void PublishIteration(const SearchIteration& iteration, const PositionRequest& request);
+
+    Search search;
+    TripleBuffer<PositionRequest> positions;
+    TripleBuffer<AnalysisSnapshot> snapshots;
+
+    // Bumped on every request so that the running search notices it has to stop
+    std::atomic<uint32_t> signal = 0;
+    std::atomic<bool> isEnabled = false;
+    std::atomic<int> lineCount = 1;
+    std::atomic<bool> isExiting = false;
+    uint32_t positionGeneration = 0;
+
+    std::thread thread;
+};
@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include "AnalysisWorker.h"
+#include "Position.h"
 #include "Tile.h"
 #include "Mountain/audio/audio.hpp"
 #include "Mountain/resource/texture.hpp"
@@ -6,6 +8,14 @@
 
 class Piece;
 
+enum class GameState : uint8_t
+{
+    Playing,
+    Check,
+    Checkmate,
+    Stalemate
+};
+
 class ChessBoard final
 {
     STATIC_CLASS(ChessBoard)
@@ -17,13 +27,22 @@ public:
     static inline Mountain::List<Piece*> pieces;
     static inline std::array<std::array<Tile*, 8>, 8> tiles;
     static inline Mountain::List<Tile*> availableTiles;
+    // Legal destination tiles of the side to move, indexed by the square of the piece
+    static inline std::array<Mountain::List<Tile*>, SquareCount> legalTiles;
+    static inline GameState gameState = GameState::Playing;
     static inline Piece* draggedPiece;
     static inline Piece* selectedPiece;
     static inline Piece* enPassantPiece;
+    static inline bool isWhiteToMove = true;
+    static inline AnalysisWorker* analysisWorker = nullptr;
+    static inline bool isAnalysisEnabled = false;
+    static inline int analysisLineCount = 1;
 
 public:
     static void CleanUp();
     static void Render();
+    static void RenderGameState();
+    static void RenderAnalysis();
     static void Initialize();
     static void InitTiles();
     static void InitPieces();
@@ -33,9 +52,10 @@ public:
     static void HandleEnPassant(Vector2i mousePosToTiles);
     static void HandlePromotion();
     static void HandleCastle(Vector2i newTile);
-    static bool IsTileProtected(Vector2i newTile, const Piece* piece);
-    static bool IsPinned(Piece* piece, Tile* newTile);
     static Piece* GetKing(bool isWhite);
+    static void OnMovePlayed(const Piece* movedPiece);
+    static void OnPositionChanged();
+    [[nodiscard]] static Position ToPosition();
 
 public:
     static void LoadResources();
@@ -43,7 +63,6 @@ public:
     [[nodiscard]] static Vector2i ToTiles(Vector2 pixelPosition);
     static Piece* GetPieceFromTile(const Vector2i& tilePosition);
     static void AddTileIfInBoard(Mountain::List<Vector2i>& tilesPos, Mountain::List<Tile*>& result);
-    static bool IsTherePieceOnTile(const Vector2i& tilePosition);
     static bool IsOnBoard(const Vector2i& tilePosition);
     static Tile* GetTileSafe(const Vector2i& tilePosition);
     static Piece* GetPieceFromTileSafe(const Vector2i& tilePosition);
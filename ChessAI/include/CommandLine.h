@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+// Argument parsing shared by the command line tools
+class CommandLine
+{
+public:
+    CommandLine() = delete;
+
+    static constexpr uint64_t MaxThreads = 1024;
+    static constexpr uint64_t MaxHashMegabytes = 1 << 20;
+
+    // Rejects anything but an unsigned decimal number in [minimum, maximum]
+    [[nodiscard]] static bool ParseValue(const char* text, const uint64_t minimum, const uint64_t maximum, uint64_t& value)
+    {
+        const char* end = text + std::strlen(text);
+        const auto [pointer, error] = std::from_chars(text, end, value);
+        return error == std::errc() && pointer == end && value >= minimum && value <= maximum;
+    }
+};
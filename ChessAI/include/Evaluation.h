@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Move.h"
+
+class Position;
+
+struct Score
+{
+    int middleGame = 0;
+    int endGame = 0;
+};
+
+// Every term of the evaluation is a weight multiplied by a feature count, so the tuner can compute
+// evaluations from the feature coefficients alone
+enum EvaluationParameter : uint16_t
+{
+    // Indexed by PieceType
+    MaterialOffset = 0,
+    // Indexed by PieceType * 64 + square, seen from white's point of view
+    PieceSquareOffset = MaterialOffset + 6,
+    // Indexed by rank, seen from the pawn's side
+    PassedPawnOffset = PieceSquareOffset + 6 * SquareCount,
+    DoubledPawnIndex = PassedPawnOffset + 8,
+    IsolatedPawnIndex,
+    BishopPairIndex,
+    RookOpenFileIndex,
+    RookSemiOpenFileIndex,
+    // Indexed by PieceType, per reachable square
+    MobilityOffset,
+
+    EvaluationParameterCount = MobilityOffset + 6
+};
+
+using EvaluationParameters = std::array<Score, EvaluationParameterCount>;
+
+struct EvaluationTrace
+{
+    // White minus black feature counts
+    std::array<int, EvaluationParameterCount> coefficients{};
+    int phase = 0;
+};
+
+class Evaluation final
+{
+public:
+    static constexpr int MaxPhase = 24;
+    static constexpr int Tempo = 10;
+
+    Evaluation() = delete;
+
+    // Centipawn score from the point of view of the side to move
+    [[nodiscard]] static int Evaluate(const Position& position);
+    static void Trace(const Position& position, EvaluationTrace& trace);
+};
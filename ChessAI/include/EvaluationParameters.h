@@ -0,0 +1,79 @@
+﻿#pragma once
+
+// Generated by the Tuner project from labelled positions, do not edit by hand
+
+#include "Evaluation.h"
+
+constexpr EvaluationParameters TunedParameters = {{
+    // Material
+    { 0, 0 }, { 900, 940 }, { 500, 520 }, { 330, 320 }, { 320, 300 }, { 100, 120 },
+
+    // King piece-square table
+    { -30, -50 }, { -40, -40 }, { -40, -30 }, { -50, -20 }, { -50, -20 }, { -40, -30 }, { -40, -40 }, { -30, -50 },
+    { -30, -30 }, { -40, -20 }, { -40, -10 }, { -50, 0 }, { -50, 0 }, { -40, -10 }, { -40, -20 }, { -30, -30 },
+    { -30, -30 }, { -40, -10 }, { -40, 20 }, { -50, 30 }, { -50, 30 }, { -40, 20 }, { -40, -10 }, { -30, -30 },
+    { -30, -30 }, { -40, -10 }, { -40, 30 }, { -50, 40 }, { -50, 40 }, { -40, 30 }, { -40, -10 }, { -30, -30 },
+    { -20, -30 }, { -30, -10 }, { -30, 30 }, { -40, 40 }, { -40, 40 }, { -30, 30 }, { -30, -10 }, { -20, -30 },
+    { -10, -30 }, { -20, -10 }, { -20, 20 }, { -20, 30 }, { -20, 30 }, { -20, 20 }, { -20, -10 }, { -10, -30 },
+    { 20, -30 }, { 20, -30 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 20, -30 }, { 20, -30 },
+    { 20, -50 }, { 30, -30 }, { 10, -30 }, { 0, -30 }, { 0, -30 }, { 10, -30 }, { 30, -30 }, { 20, -50 },
+
+    // Queen piece-square table
+    { -20, -20 }, { -10, -10 }, { -10, -10 }, { -5, -5 }, { -5, -5 }, { -10, -10 }, { -10, -10 }, { -20, -20 },
+    { -10, -10 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -10, -10 },
+    { -10, -10 }, { 0, 0 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { -10, -10 },
+    { -5, -5 }, { 0, 0 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { -5, -5 },
+    { 0, 0 }, { 0, 0 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { -5, -5 },
+    { -10, -10 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { -10, -10 },
+    { -10, -10 }, { 0, 0 }, { 5, 5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -10, -10 },
+    { -20, -20 }, { -10, -10 }, { -10, -10 }, { -5, -5 }, { -5, -5 }, { -10, -10 }, { -10, -10 }, { -20, -20 },
+
+    // Rook piece-square table
+    { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+    { 5, 5 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 5, 5 },
+    { -5, -5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -5, -5 },
+    { -5, -5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -5, -5 },
+    { -5, -5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -5, -5 },
+    { -5, -5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -5, -5 },
+    { -5, -5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -5, -5 },
+    { 0, 0 }, { 0, 0 }, { 0, 0 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+
+    // Bishop piece-square table
+    { -20, -20 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -20, -20 },
+    { -10, -10 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -10, -10 },
+    { -10, -10 }, { 0, 0 }, { 5, 5 }, { 10, 10 }, { 10, 10 }, { 5, 5 }, { 0, 0 }, { -10, -10 },
+    { -10, -10 }, { 5, 5 }, { 5, 5 }, { 10, 10 }, { 10, 10 }, { 5, 5 }, { 5, 5 }, { -10, -10 },
+    { -10, -10 }, { 0, 0 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 0, 0 }, { -10, -10 },
+    { -10, -10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { -10, -10 },
+    { -10, -10 }, { 5, 5 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 5, 5 }, { -10, -10 },
+    { -20, -20 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -10, -10 }, { -20, -20 },
+
+    // Knight piece-square table
+    { -50, -50 }, { -40, -40 }, { -30, -30 }, { -30, -30 }, { -30, -30 }, { -30, -30 }, { -40, -40 }, { -50, -50 },
+    { -40, -40 }, { -20, -20 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { -20, -20 }, { -40, -40 },
+    { -30, -30 }, { 0, 0 }, { 10, 10 }, { 15, 15 }, { 15, 15 }, { 10, 10 }, { 0, 0 }, { -30, -30 },
+    { -30, -30 }, { 5, 5 }, { 15, 15 }, { 20, 20 }, { 20, 20 }, { 15, 15 }, { 5, 5 }, { -30, -30 },
+    { -30, -30 }, { 0, 0 }, { 15, 15 }, { 20, 20 }, { 20, 20 }, { 15, 15 }, { 0, 0 }, { -30, -30 },
+    { -30, -30 }, { 5, 5 }, { 10, 10 }, { 15, 15 }, { 15, 15 }, { 10, 10 }, { 5, 5 }, { -30, -30 },
+    { -40, -40 }, { -20, -20 }, { 0, 0 }, { 5, 5 }, { 5, 5 }, { 0, 0 }, { -20, -20 }, { -40, -40 },
+    { -50, -50 }, { -40, -40 }, { -30, -30 }, { -30, -30 }, { -30, -30 }, { -30, -30 }, { -40, -40 }, { -50, -50 },
+
+    // Pawn piece-square table
+    { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+    { 50, 50 }, { 50, 50 }, { 50, 50 }, { 50, 50 }, { 50, 50 }, { 50, 50 }, { 50, 50 }, { 50, 50 },
+    { 10, 10 }, { 10, 10 }, { 20, 20 }, { 30, 30 }, { 30, 30 }, { 20, 20 }, { 10, 10 }, { 10, 10 },
+    { 5, 5 }, { 5, 5 }, { 10, 10 }, { 25, 25 }, { 25, 25 }, { 10, 10 }, { 5, 5 }, { 5, 5 },
+    { 0, 0 }, { 0, 0 }, { 0, 0 }, { 20, 20 }, { 20, 20 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+    { 5, 5 }, { -5, -5 }, { -10, -10 }, { 0, 0 }, { 0, 0 }, { -10, -10 }, { -5, -5 }, { 5, 5 },
+    { 5, 5 }, { 10, 10 }, { 10, 10 }, { -20, -20 }, { -20, -20 }, { 10, 10 }, { 10, 10 }, { 5, 5 },
+    { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 },
+
+    // Passed pawns by rank
+    { 0, 0 }, { 5, 10 }, { 5, 15 }, { 10, 25 }, { 20, 45 }, { 35, 75 }, { 60, 110 }, { 0, 0 },
+
+    // Doubled pawn, isolated pawn, bishop pair, rook on open file, rook on semi-open file
+    { -10, -20 }, { -10, -15 }, { 30, 50 }, { 25, 10 }, { 12, 8 },
+
+    // Mobility
+    { 0, 0 }, { 1, 2 }, { 2, 4 }, { 4, 5 }, { 4, 4 }, { 0, 0 }
+}};
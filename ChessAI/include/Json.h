@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include <string>
+#include <string_view>
+
+class Json
+{
+public:
+    Json() = delete;
+
+    // Returns the text ready to be placed between quotes. Control characters are replaced with spaces.
+    [[nodiscard]] static std::string Escape(const std::string_view text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+        }
+        return escaped;
+    }
+};
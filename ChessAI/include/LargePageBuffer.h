@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class AllocationMode : uint8_t
+{
+    None,
+    // Regular pages
+    Standard,
+    // Regular pages the kernel was advised to merge into transparent huge pages (Linux)
+    TransparentHugePages,
+    // Explicitly reserved huge pages: MAP_HUGETLB on Linux, MEM_LARGE_PAGES on Windows
+    HugePages
+};
+
+// Zeroed memory block for large tables, backed by huge pages when possible to reduce TLB misses.
+// Except for huge pages on Windows, physical memory is only assigned when a page is first written, on the NUMA node
+// of the thread writing it.
+class LargePageBuffer
+{
+public:
+    LargePageBuffer() = default;
+    ~LargePageBuffer();
+
+    LargePageBuffer(LargePageBuffer&& other) noexcept;
+    LargePageBuffer& operator=(LargePageBuffer&& other) noexcept;
+    LargePageBuffer(const LargePageBuffer&) = delete;
+    LargePageBuffer& operator=(const LargePageBuffer&) = delete;
+
+    // Tries huge pages, then transparent huge pages, then regular pages. Only regular pages are used if useLargePages is false.
+    [[nodiscard]] static LargePageBuffer Allocate(size_t bytes, bool useLargePages);
+
+    [[nodiscard]] void* Get() const { return memory; }
+    // May be larger than requested, rounded up to the page size
+    [[nodiscard]] size_t GetSize() const { return size; }
+    [[nodiscard]] AllocationMode GetMode() const { return mode; }
+
+    [[nodiscard]] static const char* GetName(AllocationMode mode);
+
+private:
+    void Free();
+
+    void* memory = nullptr;
+    size_t size = 0;
+    AllocationMode mode = AllocationMode::None;
+};
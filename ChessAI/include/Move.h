@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "PieceType.h"
+
+// Squares are indexed like the tiles of the board: x + y * 8, with y = 0 being the black back rank (a8 = 0, h1 = 63)
+constexpr uint8_t SquareCount = 64;
+constexpr uint8_t NoSquare = 64;
+
+[[nodiscard]] constexpr uint8_t MakeSquare(const int x, const int y) { return static_cast<uint8_t>(x + y * 8); }
+[[nodiscard]] constexpr int GetSquareX(const uint8_t square) { return square & 7; }
+[[nodiscard]] constexpr int GetSquareY(const uint8_t square) { return square >> 3; }
+
+enum class MoveFlag : uint8_t
+{
+    Normal,
+    Promotion,
+    EnPassant,
+    Castle
+};
+
+class Move
+{
+public:
+    constexpr Move() = default;
+
+    constexpr Move(const uint8_t from, const uint8_t to, const MoveFlag flag = MoveFlag::Normal, const PieceType promotion = PieceType::Queen)
+        : data(static_cast<uint16_t>(from | to << 6 | (static_cast<int>(promotion) - static_cast<int>(PieceType::Queen)) << 12
+            | static_cast<int>(flag) << 14))
+    {
+    }
+
+    [[nodiscard]] constexpr uint8_t GetFrom() const { return data & 0x3F; }
+    [[nodiscard]] constexpr uint8_t GetTo() const { return data >> 6 & 0x3F; }
+    [[nodiscard]] constexpr MoveFlag GetFlag() const { return static_cast<MoveFlag>(data >> 14); }
+    [[nodiscard]] constexpr PieceType GetPromotion() const { return static_cast<PieceType>((data >> 12 & 3) + static_cast<int>(PieceType::Queen)); }
+    [[nodiscard]] constexpr bool IsNull() const { return data == 0; }
+    [[nodiscard]] constexpr uint16_t GetData() const { return data; }
+
+    [[nodiscard]] std::string ToUci() const;
+
+    [[nodiscard]] static constexpr Move FromData(const uint16_t data)
+    {
+        Move move;
+        move.data = data;
+        return move;
+    }
+
+    constexpr bool operator==(const Move&) const = default;
+
+private:
+    uint16_t data = 0;
+};
+
+class MoveList
+{
+public:
+    static constexpr size_t Capacity = 256;
+
+    void Add(const Move move) { moves[size++] = move; }
+    void Clear() { size = 0; }
+
+    [[nodiscard]] size_t GetSize() const { return size; }
+    [[nodiscard]] bool Contains(Move move) const;
+
+    Move& operator[](const size_t index) { return moves[index]; }
+    const Move& operator[](const size_t index) const { return moves[index]; }
+
+    Move* begin() { return moves.data(); }
+    Move* end() { return moves.data() + size; }
+    [[nodiscard]] const Move* begin() const { return moves.data(); }
+    [[nodiscard]] const Move* end() const { return moves.data() + size; }
+
+private:
+    std::array<Move, Capacity> moves;
+    size_t size = 0;
+};
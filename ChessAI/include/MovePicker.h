@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <array>
+
+#include "Move.h"
+
+class Position;
+
+// Indexed by [isWhite][from][to]
+using HistoryTable = std::array<std::array<std::array<int, SquareCount>, SquareCount>, 2>;
+
+// Hands out the pseudo-legal moves of a position one at a time, generating them lazily in the order they are
+// most likely to cause a cutoff: the transposition table move, captures by MVV-LVA, killers, then quiets by history
+class MovePicker
+{
+public:
+    MovePicker(const Position& position, Move ttMove, const std::array<Move, 2>& killers, const HistoryTable& history, bool skipQuiets);
+
+    [[nodiscard]] Move Next();
+
+private:
+    enum class Stage : uint8_t
+    {
+        TtMove,
+        GenerateNoisy,
+        Noisy,
+        Killers,
+        GenerateQuiet,
+        Quiet,
+        Done
+    };
+
+    [[nodiscard]] Move PickBest();
+    [[nodiscard]] bool IsAlreadyPicked(Move move) const;
+    void ScoreNoisy();
+    void ScoreQuiet();
+
+    const Position& position;
+    const HistoryTable& history;
+    Move ttMove;
+    std::array<Move, 2> killers;
+    bool skipQuiets;
+
+    Stage stage = Stage::TtMove;
+    MoveList moves;
+    std::array<int, MoveList::Capacity> scores{};
+    size_t index = 0;
+    size_t killerIndex = 0;
+};
@@ -0,0 +1,15 @@
+﻿#pragma once
+
+#include <cstddef>
+
+// Processor groups of the machine, as reported by the operating system
+class Numa
+{
+public:
+    Numa() = delete;
+
+    // Nodes with at least one processor, 1 when the topology is unknown
+    [[nodiscard]] static size_t GetNodeCount();
+    // Restricts the calling thread to the processors of a node, so that the memory it touches first is allocated on that node
+    static bool BindThisThread(size_t node);
+};
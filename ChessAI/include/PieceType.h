@@ -0,0 +1,13 @@
+﻿#pragma once
+
+#include <cstdint>
+
+enum class PieceType : uint8_t
+{
+    King,
+    Queen,
+    Rook,
+    Bishop,
+    Knight,
+    Pawn
+};
@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Move.h"
+#include "PieceType.h"
+
+// Pieces are stored as 1 + type for white and 7 + type for black, so that 0 is an empty square
+// and piece - 1 matches the index of the piece textures
+constexpr uint8_t NoPiece = 0;
+
+[[nodiscard]] constexpr uint8_t MakePiece(const PieceType type, const bool isWhite) { return static_cast<uint8_t>(1 + static_cast<int>(type) + (isWhite ? 0 : 6)); }
+[[nodiscard]] constexpr PieceType GetPieceType(const uint8_t piece) { return static_cast<PieceType>((piece - 1) % 6); }
+[[nodiscard]] constexpr bool IsWhitePiece(const uint8_t piece) { return piece <= 6; }
+
+enum CastlingRights : uint8_t
+{
+    WhiteKingSide = 1 << 0,
+    WhiteQueenSide = 1 << 1,
+    BlackKingSide = 1 << 2,
+    BlackQueenSide = 1 << 3
+};
+
+enum class MoveGeneration : uint8_t
+{
+    // Captures and promotions
+    Noisy,
+    Quiet,
+    All
+};
+
+struct UndoInfo
+{
+    uint64_t hash;
+    uint8_t captured;
+    uint8_t castlingRights;
+    uint8_t enPassantSquare;
+    uint16_t halfmoveClock;
+};
+
+// Self-contained board representation used by the engine. Unlike ChessBoard, it does not depend on the
+// renderer and is trivially copyable, so each search thread works on its own copy.
+class Position
+{
+public:
+    static constexpr std::string_view StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    std::array<uint8_t, SquareCount> board{};
+    std::array<uint8_t, 2> kingSquares{ NoSquare, NoSquare };
+    std::array<std::array<uint8_t, 6>, 2> pieceCounts{};
+    bool isWhiteToMove = true;
+    uint8_t castlingRights = 0;
+    uint8_t enPassantSquare = NoSquare;
+    uint16_t halfmoveClock = 0;
+    uint16_t fullmoveNumber = 1;
+    uint64_t hash = 0;
+
+public:
+    bool SetFen(std::string_view fen);
+    [[nodiscard]] std::string GetFen() const;
+
+    void Clear();
+    void AddPiece(uint8_t piece, uint8_t square);
+    // Must be called after the pieces and the state have been set manually
+    void RefreshHash();
+
+    // Returns false and leaves the position untouched if the move leaves the king in check
+    bool MakeMove(Move move, UndoInfo& undo);
+    void UnmakeMove(Move move, const UndoInfo& undo);
+    void MakeNullMove(UndoInfo& undo);
+    void UnmakeNullMove(const UndoInfo& undo);
+
+    void GenerateMoves(MoveList& result, MoveGeneration generation = MoveGeneration::All) const;
+    void GenerateLegalMoves(MoveList& result) const;
+    [[nodiscard]] bool IsPseudoLegal(Move move) const;
+    [[nodiscard]] bool IsLegal(Move move) const;
+    [[nodiscard]] bool IsNoisy(Move move) const;
+    [[nodiscard]] Move ParseUci(std::string_view uci) const;
+    // Standard algebraic notation, as used by PGN and EPD. Check and annotation suffixes are optional.
+    [[nodiscard]] Move ParseSan(std::string_view san) const;
+    [[nodiscard]] std::string ToSan(Move move) const;
+
+    [[nodiscard]] bool IsSquareAttacked(uint8_t square, bool byWhite) const;
+    [[nodiscard]] bool IsInCheck() const;
+    [[nodiscard]] bool IsInsufficientMaterial() const;
+    [[nodiscard]] bool HasNonPawnMaterial(bool isWhite) const;
+    // Number of squares the piece on the square attacks that are not occupied by its own side
+    [[nodiscard]] int GetMobility(uint8_t square) const;
+
+    [[nodiscard]] uint8_t GetPieceCount(PieceType type, bool isWhite) const { return pieceCounts[isWhite ? 0 : 1][static_cast<size_t>(type)]; }
+
+private:
+    void GeneratePieceMoves(uint8_t from, MoveList& result, MoveGeneration generation) const;
+    void GeneratePawnMoves(uint8_t from, MoveList& result, MoveGeneration generation) const;
+    void GenerateCastlingMoves(MoveList& result) const;
+    void AddPawnMove(uint8_t from, uint8_t to, MoveList& result, MoveGeneration generation) const;
+
+    void PutPiece(uint8_t piece, uint8_t square);
+    void RemovePiece(uint8_t square);
+    void MovePiece(uint8_t from, uint8_t to);
+};
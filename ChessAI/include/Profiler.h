@@ -0,0 +1,179 @@
+﻿#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Define CHESSAI_PROFILE=1 in the preprocessor definitions to enable the instrumentation.
+// When disabled, every PROFILE_* macro expands to nothing.
+#ifndef CHESSAI_PROFILE
+#define CHESSAI_PROFILE 0
+#endif
+
+enum class ProfileStage : uint8_t
+{
+    MoveGeneration,
+    Evaluation,
+    TranspositionTable,
+    Quiescence,
+    MovePicker,
+
+    Count
+};
+
+enum class ProfileCounter : uint8_t
+{
+    Nodes,
+    QuiescenceNodes,
+    BetaCutoffs,
+    TtHits,
+    TtMisses,
+    GeneratedMoves,
+
+    Count
+};
+
+constexpr size_t ProfileStageCount = static_cast<size_t>(ProfileStage::Count);
+constexpr size_t ProfileCounterCount = static_cast<size_t>(ProfileCounter::Count);
+
+struct ProfileIteration
+{
+    int depth = 0;
+    int64_t beginNanoseconds = 0;
+    int64_t endNanoseconds = 0;
+    std::array<uint64_t, ProfileCounterCount> counters{};
+    std::array<int64_t, ProfileStageCount> stageNanoseconds{};
+};
+
+// Accumulators owned by a single thread, so the hot path never touches shared memory.
+// Stage times are inclusive: a quiescence stage contains the evaluations it performs.
+class ThreadProfile
+{
+public:
+    uint32_t threadIndex = 0;
+    std::string name;
+    // Cleared when the thread exits, the profile is then handed to the next new thread
+    bool isActive = true;
+
+    std::array<uint64_t, ProfileCounterCount> counters{};
+    std::array<int64_t, ProfileStageCount> stageNanoseconds{};
+    std::array<uint64_t, ProfileStageCount> stageCalls{};
+
+    std::vector<ProfileIteration> iterations;
+
+    int64_t iterationBegin = 0;
+    std::array<uint64_t, ProfileCounterCount> iterationCounters{};
+    std::array<int64_t, ProfileStageCount> iterationStageNanoseconds{};
+
+public:
+    void Clear();
+};
+
+class Profiler final
+{
+public:
+    Profiler() = delete;
+
+    static ThreadProfile& Local();
+    static void SetThreadName(const std::string& name);
+
+    static void BeginIteration();
+    static void EndIteration(int depth);
+
+    // Resetting and exporting must only happen while no instrumented thread is running
+    static void Reset();
+    static bool ExportChromeTrace(const std::string& filepath);
+    static bool ExportCsv(const std::string& filepath);
+
+    [[nodiscard]] static int64_t Now();
+    [[nodiscard]] static const char* GetName(ProfileStage stage);
+    [[nodiscard]] static const char* GetName(ProfileCounter counter);
+
+private:
+    friend class ThreadProfileHandle;
+
+    static ThreadProfile* Register();
+    static void Retire(ThreadProfile* profile);
+
+    static inline std::mutex registryMutex;
+    static inline std::vector<std::unique_ptr<ThreadProfile>> profiles;
+    static inline const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const ProfileStage stage)
+        : stage(stage), begin(Profiler::Now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        ThreadProfile& profile = Profiler::Local();
+        const size_t index = static_cast<size_t>(stage);
+        profile.stageNanoseconds[index] += Profiler::Now() - begin;
+        profile.stageCalls[index]++;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage stage;
+    int64_t begin;
+};
+
+// Owns the profile of a thread for its lifetime, so that threads created and destroyed over and over
+// (thread count changes, analysis workers) reuse the same few profiles
+class ThreadProfileHandle
+{
+public:
+    ThreadProfileHandle()
+        : profile(Profiler::Register())
+    {
+    }
+
+    ~ThreadProfileHandle()
+    {
+        Profiler::Retire(profile);
+    }
+
+    ThreadProfileHandle(const ThreadProfileHandle&) = delete;
+    ThreadProfileHandle& operator=(const ThreadProfileHandle&) = delete;
+
+    ThreadProfile* const profile;
+};
+
+inline ThreadProfile& Profiler::Local()
+{
+    thread_local ThreadProfileHandle handle;
+    return *handle.profile;
+}
+
+inline int64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+#if CHESSAI_PROFILE
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(stage) const ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
+#define PROFILE_ADD(counter, amount) (Profiler::Local().counters[static_cast<size_t>(counter)] += (amount))
+#define PROFILE_COUNT(counter) PROFILE_ADD(counter, 1)
+#define PROFILE_ITERATION_BEGIN() Profiler::BeginIteration()
+#define PROFILE_ITERATION_END(depth) Profiler::EndIteration(depth)
+#define PROFILE_THREAD_NAME(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_SCOPE(stage) ((void) 0)
+#define PROFILE_ADD(counter, amount) ((void) 0)
+#define PROFILE_COUNT(counter) ((void) 0)
+#define PROFILE_ITERATION_BEGIN() ((void) 0)
+#define PROFILE_ITERATION_END(depth) ((void) 0)
+#define PROFILE_THREAD_NAME(name) ((void) 0)
+#endif
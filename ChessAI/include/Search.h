@@ -0,0 +1,206 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "MovePicker.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+#include "WorkerThread.h"
+
+constexpr int MaxPly = 128;
+constexpr int MaxDepth = 100;
+constexpr int InfiniteScore = 32001;
+constexpr int MateScore = 32000;
+constexpr int MateInMaxPly = MateScore - MaxPly;
+
+struct SearchLimits
+{
+    int depth = MaxDepth;
+    // Zero means unlimited
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    // Number of best root moves searched with an exact score and reported with their own PV
+    int multiPv = 1;
+    // Polled along with the clock by the main search thread, the search stops as soon as it returns true
+    std::function<bool()> stopCondition;
+};
+
+// Selective search techniques, switchable at runtime to measure what each one brings
+struct SearchOptions
+{
+    // Skips the move and searches a reduced depth, cutting off if the position is still above beta
+    bool nullMovePruning = true;
+    // Searches the quiet moves ordered late at a reduced depth, depending on their history
+    bool lateMoveReductions = true;
+    // Prunes quiet moves, or the whole node, when the static evaluation is far from the window
+    bool futilityPruning = true;
+    // Drops to the quiescence search when the static evaluation is far below alpha
+    bool razoring = true;
+    // Searches moves giving check one ply deeper
+    bool checkExtensions = true;
+};
+
+struct PvLine
+{
+    int score = 0;
+    std::vector<Move> pv;
+};
+
+struct SearchIteration
+{
+    int depth = 0;
+    int selectiveDepth = 0;
+    int score = 0;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    int hashfull = 0;
+    // Best line, also the first of lines
+    std::vector<Move> pv;
+    // MultiPV lines, best first
+    std::vector<PvLine> lines;
+};
+
+struct SearchResult
+{
+    Move bestMove;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    std::vector<Move> pv;
+    std::vector<PvLine> lines;
+};
+
+struct RootMove
+{
+    Move move;
+    // Exact or bound score of the current iteration, -InfiniteScore if the move was refuted by the null window
+    int score = -InfiniteScore;
+    int previousScore = -InfiniteScore;
+    std::vector<Move> pv;
+};
+
+class Search;
+
+// Tables written at every node, allocated by the thread using them so that they live on its NUMA node
+struct SearchThreadTables
+{
+    HistoryTable history{};
+    std::array<std::array<Move, 2>, MaxPly> killers{};
+    std::array<std::array<Move, MaxPly>, MaxPly> pvTable{};
+    std::array<int, MaxPly> pvLength{};
+};
+
+// State of one search thread. The first thread runs in the thread calling Search::Run,
+// the other ones are helpers sharing the transposition table (lazy SMP).
+class SearchThread
+{
+public:
+    SearchThread(Search& search, size_t index);
+
+    SearchThread(const SearchThread&) = delete;
+    SearchThread& operator=(const SearchThread&) = delete;
+
+    // Runs the job on the thread, returning immediately
+    void StartJob(std::function<void()> job);
+    void StartSearching();
+    void WaitForJobFinished();
+
+private:
+    friend class Search;
+
+    void InitializeTables();
+    void IterativeDeepening();
+    int Negamax(int alpha, int beta, int depth, int ply);
+    int Quiescence(int alpha, int beta, int ply);
+
+    [[nodiscard]] bool IsMainThread() const { return index == 0; }
+    [[nodiscard]] bool IsDraw() const;
+    [[nodiscard]] bool IsZugzwangProne() const;
+    void IncrementNodes();
+    void UpdatePv(int ply, Move move);
+    void UpdateQuietStatistics(Move bestMove, int depth, int ply, const MoveList& quietsTried);
+    void UpdateRootMove(size_t rootIndex, int score, bool isBest);
+
+    Search& search;
+    size_t index;
+
+    Position position;
+    std::vector<uint64_t> hashHistory;
+    std::unique_ptr<SearchThreadTables> tables;
+    std::array<bool, MaxPly> isNullMove{};
+    // Null moves of a color, white first, are disabled below this ply while one of its null move cutoffs is being verified
+    std::array<int, 2> nullMoveMinPlies{};
+    int rootDepth = 0;
+
+    // Kept in rank order: the root is searched once per MultiPV line, each time excluding the lines already found
+    std::vector<RootMove> rootMoves;
+    size_t pvIndex = 0;
+
+    // Only written by the owning thread, relaxed loads from the others are enough to sum them up
+    std::atomic<uint64_t> nodes = 0;
+    int selectiveDepth = 0;
+    int completedDepth = 0;
+    std::vector<PvLine> completedLines;
+
+    // Not created for the main thread. Declared last, so that it exits before the state it searches is destroyed.
+    std::unique_ptr<WorkerThread> worker;
+};
+
+class Search
+{
+public:
+    explicit Search(size_t hashMegabytes = 16, size_t threadCount = 1);
+    ~Search();
+
+    Search(const Search&) = delete;
+    Search& operator=(const Search&) = delete;
+
+    // Blocks until the limits are reached or Stop is called. gameHistory holds the hashes of the positions
+    // that led to this one, and is used to detect repetitions.
+    SearchResult Run(const Position& position, const SearchLimits& limits, const std::vector<uint64_t>& gameHistory = {});
+    void Stop();
+
+    // Must not be called while searching
+    void SetThreadCount(size_t count);
+    void SetHashSize(size_t megabytes);
+    // Backs the transposition table with huge pages when available, on by default
+    void SetLargePages(bool enabled);
+    // Spreads the helper threads over the NUMA nodes, on by default. Only has an effect on machines with several nodes.
+    void SetThreadBinding(bool enabled);
+    void Clear();
+
+    [[nodiscard]] size_t GetThreadCount() const { return threads.size(); }
+    [[nodiscard]] size_t GetHashSizeInBytes() const { return transpositionTable.GetSizeInBytes(); }
+    [[nodiscard]] AllocationMode GetAllocationMode() const { return transpositionTable.GetAllocationMode(); }
+    // Number of NUMA nodes the threads are spread over
+    [[nodiscard]] size_t GetBoundNodeCount() const;
+    [[nodiscard]] uint64_t GetNodes() const;
+
+    // Called by the main search thread after each completed iteration
+    std::function<void(const SearchIteration&)> onIteration;
+    // Must not be changed while searching
+    SearchOptions options;
+
+private:
+    friend class SearchThread;
+
+    [[nodiscard]] int64_t GetElapsedMilliseconds() const;
+    void CheckLimits();
+    // Shares the work between the threads, which also places the pages of a new table on their nodes
+    void ClearTranspositionTable();
+
+    TranspositionTable transpositionTable;
+    size_t hashMegabytes = 0;
+    bool useLargePages = true;
+    bool isThreadBindingEnabled = true;
+    std::vector<std::unique_ptr<SearchThread>> threads;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> stopped = false;
+};
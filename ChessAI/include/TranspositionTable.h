@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "LargePageBuffer.h"
+#include "Move.h"
+
+enum class Bound : uint8_t
+{
+    None,
+    Upper,
+    Lower,
+    Exact
+};
+
+struct TtEntry
+{
+    Move move;
+    int16_t score = 0;
+    int16_t evaluation = 0;
+    uint8_t depth = 0;
+    Bound bound = Bound::None;
+};
+
+// Shared between the search threads without locking: each slot stores the key xor-ed with its data,
+// so a slot torn by a concurrent write fails the key check instead of returning corrupted data
+class TranspositionTable
+{
+public:
+    TranspositionTable() = default;
+    explicit TranspositionTable(size_t megabytes, bool useLargePages = true);
+
+    // The new table must be cleared before use
+    void Resize(size_t megabytes, bool useLargePages);
+    void Clear();
+    // Clears one of partCount equal parts of the slots, the first part also resets the generation. Parts cleared by
+    // threads bound to different NUMA nodes spread the pages of a new table over these nodes.
+    void ClearPart(size_t part, size_t partCount);
+    void NewSearch();
+
+    [[nodiscard]] bool Probe(uint64_t key, TtEntry& entry) const;
+    void Store(uint64_t key, Move move, int score, int evaluation, int depth, Bound bound);
+
+    // Permill of the slots written during the current search, sampled over the first thousand slots
+    [[nodiscard]] int GetHashfull() const;
+    [[nodiscard]] size_t GetSizeInBytes() const { return slotCount * sizeof(Slot); }
+    [[nodiscard]] AllocationMode GetAllocationMode() const { return memory.GetMode(); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> data;
+    };
+
+    [[nodiscard]] static uint64_t Pack(Move move, int score, int evaluation, int depth, Bound bound, uint8_t generation);
+    [[nodiscard]] static TtEntry Unpack(uint64_t data);
+    [[nodiscard]] static uint8_t GetGeneration(const uint64_t data) { return static_cast<uint8_t>(data >> 58); }
+    [[nodiscard]] Slot& GetSlot(const uint64_t key) const { return slots[key & (slotCount - 1)]; }
+
+    LargePageBuffer memory;
+    Slot* slots = nullptr;
+    size_t slotCount = 0;
+    uint8_t generation = 0;
+};
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free handoff of the latest value from one writer thread to one reader thread.
+// Neither side ever waits: the writer always has a buffer of its own to fill, and the reader keeps
+// the last published value until a newer one is available.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side
+    T& GetWriteBuffer() { return buffers[writeIndex]; }
+
+    void Publish()
+    {
+        writeIndex = middle.exchange(writeIndex | DirtyBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // Reader side, returns true if a newer value has been published since the last call
+    bool Update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & DirtyBit))
+            return false;
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    [[nodiscard]] const T& Read() const { return buffers[readIndex]; }
+
+private:
+    static constexpr uint8_t IndexMask = 0b011;
+    static constexpr uint8_t DirtyBit = 0b100;
+
+    std::array<T, 3> buffers{};
+    uint8_t writeIndex = 0;
+    std::atomic<uint8_t> middle = 1;
+    uint8_t readIndex = 2;
+};
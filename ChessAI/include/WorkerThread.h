@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Thread waiting for jobs, which are run one at a time. Creating it once and handing it jobs avoids
+// paying for a new thread each time some work is split between threads.
+class WorkerThread
+{
+public:
+    WorkerThread();
+    ~WorkerThread();
+
+    WorkerThread(const WorkerThread&) = delete;
+    WorkerThread& operator=(const WorkerThread&) = delete;
+
+    // Runs the job on the thread, returning immediately. The previous job must be finished.
+    void StartJob(std::function<void()> job);
+    void WaitForJobFinished();
+
+private:
+    void IdleLoop();
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::function<void()> job;
+    bool isExiting = false;
+    std::thread thread;
+};
@@ -0,0 +1,117 @@
+﻿#include "AnalysisWorker.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+AnalysisWorker::AnalysisWorker(const size_t threadCount, const size_t hashMegabytes)
+    : search(hashMegabytes, threadCount)
+{
+    thread = std::thread(&AnalysisWorker::Loop, this);
+}
+
+AnalysisWorker::~AnalysisWorker()
+{
+    isExiting.store(true, std::memory_order_relaxed);
+    Signal();
+    thread.join();
+}
+
+void AnalysisWorker::SetPosition(const Position& position)
+{
+    PositionRequest& request = positions.GetWriteBuffer();
+    request.position = position;
+    request.generation = ++positionGeneration;
+    positions.Publish();
+    Signal();
+}
+
+void AnalysisWorker::SetEnabled(const bool enabled)
+{
+    isEnabled.store(enabled, std::memory_order_relaxed);
+    Signal();
+}
+
+void AnalysisWorker::SetLineCount(const int count)
+{
+    lineCount.store(std::clamp(count, 1, static_cast<int>(AnalysisSnapshot::MaxLines)), std::memory_order_relaxed);
+    Signal();
+}
+
+const AnalysisSnapshot& AnalysisWorker::GetSnapshot()
+{
+    snapshots.Update();
+    return snapshots.Read();
+}
+
+void AnalysisWorker::Loop()
+{
+    PROFILE_THREAD_NAME("Analysis");
+
+    PositionRequest request;
+    bool needsSearch = false;
+
+    while (!isExiting.load(std::memory_order_relaxed))
+    {
+        // Read before looking for work, so that a request arriving in between wakes the wait below up
+        const uint32_t observedSignal = signal.load(std::memory_order_acquire);
+
+        if (positions.Update())
+        {
+            request = positions.Read();
+            needsSearch = true;
+        }
+
+        if (needsSearch && isEnabled.load(std::memory_order_relaxed))
+        {
+            SearchLimits limits;
+            limits.multiPv = lineCount.load(std::memory_order_relaxed);
+            limits.stopCondition = [this, observedSignal]
+            {
+                return signal.load(std::memory_order_relaxed) != observedSignal;
+            };
+            search.onIteration = [this, &request](const SearchIteration& iteration)
+            {
+                PublishIteration(iteration, request);
+            };
+
+            search.Run(request.position, limits);
+
+            // Interrupted searches are resumed, unless a new position is waiting
+            if (signal.load(std::memory_order_relaxed) == observedSignal)
+                needsSearch = false;
+            continue;
+        }
+
+        signal.wait(observedSignal, std::memory_order_acquire);
+    }
+}
+
+void AnalysisWorker::Signal()
+{
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+}
+
+void AnalysisWorker::PublishIteration(const SearchIteration& iteration, const PositionRequest& request)
+{
+    AnalysisSnapshot& snapshot = snapshots.GetWriteBuffer();
+    snapshot.generation = request.generation;
+    snapshot.isWhiteToMove = request.position.isWhiteToMove;
+    snapshot.depth = iteration.depth;
+    snapshot.selectiveDepth = iteration.selectiveDepth;
+    snapshot.nodes = iteration.nodes;
+    snapshot.milliseconds = iteration.milliseconds;
+    snapshot.hashfull = iteration.hashfull;
+
+    snapshot.lineCount = static_cast<uint8_t>(std::min(iteration.lines.size(), AnalysisSnapshot::MaxLines));
+    for (size_t i = 0; i < snapshot.lineCount; i++)
+    {
+        const PvLine& line = iteration.lines[i];
+        AnalysisLine& snapshotLine = snapshot.lines[i];
+        snapshotLine.score = line.score;
+        snapshotLine.pvLength = static_cast<uint8_t>(std::min(line.pv.size(), AnalysisLine::MaxPvLength));
+        std::copy_n(line.pv.begin(), snapshotLine.pvLength, snapshotLine.pv.begin());
+    }
+    snapshots.Publish();
+}
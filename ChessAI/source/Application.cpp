@@ -6,6 +6,8 @@
 #include "Mountain/resource/resource_manager.hpp"
 #include "Mountain/utils/random.hpp"
 
+#include "Profiler.h"
+
 Application::Application(const char* windowTitle)
     : Game(windowTitle, Vector2i(880))
 {
@@ -27,6 +29,13 @@ void Application::LoadResources()
 
 void Application::Shutdown()
 {
+    ChessBoard::CleanUp();
+
+#if CHESSAI_PROFILE
+    Profiler::ExportChromeTrace("profile_trace.json");
+    Profiler::ExportCsv("profile.csv");
+#endif
+
     Game::Shutdown();
 }
 
@@ -1,5 +1,12 @@
 ﻿#include "ChessBoard.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <ImGui/imgui.h>
+
 #include "Mountain/window.hpp"
 #include "Mountain/input/input.hpp"
 #include "Mountain/rendering/draw.hpp"
@@ -9,6 +16,8 @@
 
 void ChessBoard::CleanUp()
 {
+    delete analysisWorker;
+    analysisWorker = nullptr;
     pieces.Iterate([](Piece** piece){ delete *piece; });
 }
 
@@ -21,6 +30,91 @@ void ChessBoard::Render()
         if (tile)
             Mountain::Draw::Circle(tile->position, Tile::size/3.f, Vector2::One(), Mountain::Color::Black());
     }
+
+    if (gameState == GameState::Check || gameState == GameState::Checkmate)
+    {
+        if (const Piece* king = GetKing(isWhiteToMove))
+            Mountain::Draw::Circle(king->tile->position, Tile::size/2.5f, Vector2::One(), Mountain::Color::Red());
+    }
+
+    RenderGameState();
+    RenderAnalysis();
+}
+
+void ChessBoard::RenderGameState()
+{
+    ImGui::Begin("Game");
+
+    const char* side = isWhiteToMove ? "White" : "Black";
+    switch (gameState)
+    {
+        case GameState::Playing:
+            ImGui::Text("%s to move", side);
+            break;
+        case GameState::Check:
+            ImGui::Text("%s to move, check", side);
+            break;
+        case GameState::Checkmate:
+            ImGui::Text("Checkmate, %s wins", isWhiteToMove ? "Black" : "White");
+            break;
+        case GameState::Stalemate:
+            ImGui::Text("Stalemate");
+            break;
+    }
+
+    ImGui::End();
+}
+
+void ChessBoard::RenderAnalysis()
+{
+    ImGui::Begin("Analysis");
+
+    if (ImGui::Checkbox("Enabled", &isAnalysisEnabled))
+        analysisWorker->SetEnabled(isAnalysisEnabled);
+    if (ImGui::SliderInt("Lines", &analysisLineCount, 1, static_cast<int>(AnalysisSnapshot::MaxLines)))
+        analysisWorker->SetLineCount(analysisLineCount);
+    ImGui::Text("Hash: %llu MB on %s", static_cast<unsigned long long>(analysisWorker->GetHashSizeInBytes() >> 20),
+        LargePageBuffer::GetName(analysisWorker->GetHashAllocationMode()));
+
+    // Never waits for the engine: the snapshot is whatever the last completed iteration published
+    const AnalysisSnapshot& snapshot = analysisWorker->GetSnapshot();
+    if (isAnalysisEnabled && snapshot.generation == analysisWorker->GetPositionGeneration() && snapshot.lineCount > 0)
+    {
+        const uint64_t nodesPerSecond = snapshot.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(snapshot.milliseconds, 1));
+        ImGui::Text("Depth: %d/%d", snapshot.depth, snapshot.selectiveDepth);
+        ImGui::Text("Nodes: %llu (%llu kN/s)", static_cast<unsigned long long>(snapshot.nodes),
+            static_cast<unsigned long long>(nodesPerSecond / 1000));
+        ImGui::Text("Hash: %.1f%%", static_cast<float>(snapshot.hashfull) / 10.f);
+        ImGui::Separator();
+
+        for (uint8_t i = 0; i < snapshot.lineCount; i++)
+        {
+            const AnalysisLine& line = snapshot.lines[i];
+            const int whiteScore = snapshot.isWhiteToMove ? line.score : -line.score;
+
+            char score[16];
+            if (std::abs(whiteScore) >= MateInMaxPly)
+                std::snprintf(score, sizeof(score), "%sM%d", whiteScore > 0 ? "+" : "-", (MateScore - std::abs(whiteScore) + 1) / 2);
+            else
+                std::snprintf(score, sizeof(score), "%+.2f", static_cast<float>(whiteScore) / 100.f);
+
+            std::string pv;
+            for (uint8_t j = 0; j < line.pvLength; j++)
+                pv += line.pv[j].ToUci() + ' ';
+            ImGui::TextWrapped("%d. %s  %s", i + 1, score, pv.c_str());
+        }
+
+        if (snapshot.lines[0].pvLength > 0)
+        {
+            const Move bestMove = snapshot.lines[0].pv[0];
+            const Vector2i from(GetSquareX(bestMove.GetFrom()), GetSquareY(bestMove.GetFrom()));
+            const Vector2i to(GetSquareX(bestMove.GetTo()), GetSquareY(bestMove.GetTo()));
+            Mountain::Draw::Circle(tiles[from.x][from.y]->position, Tile::size/3.f, Vector2::One(), Mountain::Color::Blue());
+            Mountain::Draw::Circle(tiles[to.x][to.y]->position, Tile::size/2.5f, Vector2::One(), Mountain::Color::Blue());
+        }
+    }
+
+    ImGui::End();
 }
 
 void ChessBoard::Initialize()
@@ -28,6 +122,11 @@ void ChessBoard::Initialize()
     boardSize = static_cast<float>(boardTexture->GetSize().x);
     InitTiles();
     InitPieces();
+
+    // Leave a core to the render loop so that frame times stay stable while the engine is searching
+    const size_t searchThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    analysisWorker = new AnalysisWorker(searchThreads);
+    OnPositionChanged();
 }
 
 void ChessBoard::InitTiles()
@@ -105,14 +204,14 @@ void ChessBoard::DragAndDrop()
     {
         const Vector2i mousePosToTiles = ToTiles(mousePos);
         draggedPiece = GetPieceFromTileSafe(mousePosToTiles);
+        if (draggedPiece && draggedPiece->isWhite != isWhiteToMove)
+            draggedPiece = nullptr;
         selectedPiece = draggedPiece;
         availableTiles.Clear();
         if (selectedPiece)
         {
-            selectedPiece->GetAvailableTiles(availableTiles);
-            if (selectedPiece->pieceType == PieceType::King)
-                selectedPiece->RemoveTilesProtectedByOpponent(availableTiles);
-
+            for (Tile* tile : legalTiles[MakeSquare(mousePosToTiles.x, mousePosToTiles.y)])
+                availableTiles.Add(tile);
         }
     }
 
@@ -129,33 +228,20 @@ void ChessBoard::DragAndDrop()
             const Vector2i mousePosToTiles = ToTiles(mousePos);
             if (IsOnBoard(mousePosToTiles))
             {
-                Mountain::List<Tile*> pieceAvailableTiles;
-                draggedPiece->GetAvailableTiles(pieceAvailableTiles);
-                if (selectedPiece->pieceType == PieceType::King)
-                    selectedPiece->RemoveTilesProtectedByOpponent(pieceAvailableTiles);
-
                 Tile* droppedTile = tiles[mousePosToTiles.x][mousePosToTiles.y];
-                if (pieceAvailableTiles.Contains(droppedTile))
+                if (legalTiles[MakeSquare(draggedPiece->tilePosition.x, draggedPiece->tilePosition.y)].Contains(droppedTile))
                 {
                     HandleEnPassant(mousePosToTiles);
                     HandleCastle(mousePosToTiles);
 
-                    if (!IsPinned(draggedPiece, droppedTile))
-                    {
-                        Piece* p = GetPieceFromTile(mousePosToTiles);
-                        if (p)
-                        {
-                            draggedPiece->Move(droppedTile);
-                            DeletePiece(p);
-                        }
-                        else
-                        {
-                            draggedPiece->Move(droppedTile);
-                        }
-                    }
+                    Piece* p = GetPieceFromTile(mousePosToTiles);
+                    draggedPiece->Move(droppedTile);
+                    if (p)
+                        DeletePiece(p);
 
                     HandlePromotion();
                     availableTiles.Clear();
+                    OnMovePlayed(draggedPiece);
                 }
             }
             draggedPiece->globalPosition = draggedPiece->tile->position;
@@ -238,54 +324,87 @@ void ChessBoard::HandleCastle(const Vector2i newTile)
     }
 }
 
-bool ChessBoard::IsTileProtected(const Vector2i newTile, const Piece* piece)
+Piece* ChessBoard::GetKing(const bool isWhite)
 {
-    for (const Piece* p : pieces)
+    for (Piece* p : pieces)
     {
-        if (piece->isWhite == p->isWhite || piece == p)
-            continue;
-        Mountain::List<Tile*> pieceTiles;
-        p->GetAvailableTiles(pieceTiles);
-        if (pieceTiles.Contains(GetTileSafe(newTile)))
-            return true;
+        if (p->isWhite == isWhite && p->pieceType == PieceType::King)
+            return p;
     }
-    return false;
+    return nullptr;
 }
 
-bool ChessBoard::IsPinned(Piece* piece, Tile* newTile)
+void ChessBoard::OnMovePlayed(const Piece* movedPiece)
 {
-    Tile* oldTile = piece->tile;
-    const bool hasMoved = piece->hasMoved;
-
-    piece->Move(newTile);
-
-    const Piece* king = GetKing(piece->isWhite);
-    if (!king)
-        throw std::runtime_error("Should always get a king");
+    isWhiteToMove = !movedPiece->isWhite;
+    OnPositionChanged();
+}
 
-    if (IsTileProtected(king->tilePosition, king))
+void ChessBoard::OnPositionChanged()
+{
+    const Position position = ToPosition();
+
+    // Computed once per position, so that picking up and dropping pieces only needs lookups
+    MoveList legalMoves;
+    position.GenerateLegalMoves(legalMoves);
+    for (Mountain::List<Tile*>& list : legalTiles)
+        list.Clear();
+    for (const Move move : legalMoves)
     {
-        piece->Move(oldTile);
-        if (!hasMoved)
-            piece->hasMoved = false;
-        return true;
+        // Promotions all share the same tile, the board always promotes to a queen
+        if (move.GetFlag() == MoveFlag::Promotion && move.GetPromotion() != PieceType::Queen)
+            continue;
+        legalTiles[move.GetFrom()].Add(tiles[GetSquareX(move.GetTo())][GetSquareY(move.GetTo())]);
     }
 
-    piece->Move(oldTile);
-    if (!hasMoved)
-        piece->hasMoved = false;
+    const bool isInCheck = position.IsInCheck();
+    if (legalMoves.GetSize() == 0)
+        gameState = isInCheck ? GameState::Checkmate : GameState::Stalemate;
+    else
+        gameState = isInCheck ? GameState::Check : GameState::Playing;
 
-    return false;
+    analysisWorker->SetPosition(position);
 }
 
-Piece* ChessBoard::GetKing(const bool isWhite)
+Position ChessBoard::ToPosition()
 {
-    for (Piece* p : pieces)
+    Position result;
+
+    // Pieces are looked up by tile position, as the dragged piece is not drawn on its tile
+    const auto getUnmovedPiece = [](const Vector2i tilePosition, const PieceType type, const bool isWhite) -> const Piece*
     {
-        if (p->isWhite == isWhite && p->pieceType == PieceType::King)
-            return p;
+        for (const Piece* piece : pieces)
+        {
+            if (piece->tilePosition == tilePosition && piece->pieceType == type && piece->isWhite == isWhite && !piece->hasMoved)
+                return piece;
+        }
+        return nullptr;
+    };
+
+    for (const Piece* piece : pieces)
+        result.AddPiece(MakePiece(piece->pieceType, piece->isWhite), MakeSquare(piece->tilePosition.x, piece->tilePosition.y));
+
+    result.isWhiteToMove = isWhiteToMove;
+
+    for (const bool isWhite : { true, false })
+    {
+        const int backRank = isWhite ? 7 : 0;
+        if (!getUnmovedPiece({ 4, backRank }, PieceType::King, isWhite))
+            continue;
+        if (getUnmovedPiece({ 7, backRank }, PieceType::Rook, isWhite))
+            result.castlingRights |= isWhite ? WhiteKingSide : BlackKingSide;
+        if (getUnmovedPiece({ 0, backRank }, PieceType::Rook, isWhite))
+            result.castlingRights |= isWhite ? WhiteQueenSide : BlackQueenSide;
     }
-    return nullptr;
+
+    if (enPassantPiece && enPassantPiece->isWhite != isWhiteToMove)
+    {
+        const int behind = enPassantPiece->isWhite ? 1 : -1;
+        result.enPassantSquare = MakeSquare(enPassantPiece->tilePosition.x, enPassantPiece->tilePosition.y + behind);
+    }
+
+    result.RefreshHash();
+    return result;
 }
 
 Vector2 ChessBoard::ToPixels(const Vector2i tilePosition)
@@ -318,17 +437,6 @@ void ChessBoard::AddTileIfInBoard(Mountain::List<Vector2i>& tilesPos, Mountain::
     }
 }
 
-bool ChessBoard::IsTherePieceOnTile(const Vector2i& tilePosition)
-{
-    for (const Piece* piece : pieces)
-    {
-        if (IsOnBoard(tilePosition))
-            if (piece->globalPosition == tiles[tilePosition.x][tilePosition.y]->position)
-                return true;
-    }
-    return false;
-}
-
 bool ChessBoard::IsOnBoard(const Vector2i& tilePosition)
 {
     if (tilePosition.x > 7 || tilePosition.x < 0 || tilePosition.y > 7  || tilePosition.y < 0)
@@ -0,0 +1,147 @@
+﻿#include "Evaluation.h"
+
+#include <algorithm>
+#include <array>
+
+#include "EvaluationParameters.h"
+#include "Position.h"
+#include "Profiler.h"
+
+namespace
+{
+    // Indexed by PieceType
+    constexpr std::array PhaseWeights = { 0, 4, 2, 1, 1, 0 };
+
+    // Sums the weights of the features, used by the search
+    struct ScoreAccumulator
+    {
+        int middleGame = 0;
+        int endGame = 0;
+
+        void Add(const size_t index, const bool isWhite, const int count = 1)
+        {
+            const Score& weight = TunedParameters[index];
+            const int signedCount = isWhite ? count : -count;
+            middleGame += weight.middleGame * signedCount;
+            endGame += weight.endGame * signedCount;
+        }
+    };
+
+    // Records how many times each feature appears, used by the tuner
+    struct TraceAccumulator
+    {
+        EvaluationTrace& trace;
+
+        void Add(const size_t index, const bool isWhite, const int count = 1)
+        {
+            trace.coefficients[index] += isWhite ? count : -count;
+        }
+    };
+
+    template <typename Accumulator>
+    int EvaluateFeatures(const Position& position, Accumulator& accumulator)
+    {
+        // Pawn counts per side and file, and the rank of the least advanced pawn of each file,
+        // counted from the side's own back rank
+        std::array<std::array<int, 8>, 2> pawnCounts{};
+        std::array<std::array<int, 8>, 2> leastAdvancedPawns{};
+        leastAdvancedPawns[0].fill(8);
+        leastAdvancedPawns[1].fill(8);
+        int phase = 0;
+
+        for (uint8_t square = 0; square < SquareCount; square++)
+        {
+            const uint8_t piece = position.board[square];
+            if (piece == NoPiece || GetPieceType(piece) != PieceType::Pawn)
+                continue;
+
+            const size_t side = IsWhitePiece(piece) ? 0 : 1;
+            const int x = GetSquareX(square);
+            const int rank = side == 0 ? 7 - GetSquareY(square) : GetSquareY(square);
+            pawnCounts[side][x]++;
+            leastAdvancedPawns[side][x] = std::min(leastAdvancedPawns[side][x], rank);
+        }
+
+        for (uint8_t square = 0; square < SquareCount; square++)
+        {
+            const uint8_t piece = position.board[square];
+            if (piece == NoPiece)
+                continue;
+
+            const PieceType type = GetPieceType(piece);
+            const size_t typeIndex = static_cast<size_t>(type);
+            const bool isWhite = IsWhitePiece(piece);
+            const size_t side = isWhite ? 0 : 1;
+            const int x = GetSquareX(square);
+            // Black pieces read the tables upside down
+            const uint8_t tableSquare = isWhite ? square : square ^ 56;
+
+            accumulator.Add(MaterialOffset + typeIndex, isWhite);
+            accumulator.Add(PieceSquareOffset + typeIndex * SquareCount + tableSquare, isWhite);
+            phase += PhaseWeights[typeIndex];
+
+            switch (type)
+            {
+                case PieceType::Pawn:
+                {
+                    const int rank = isWhite ? 7 - GetSquareY(square) : GetSquareY(square);
+                    const bool hasLeftNeighbour = x > 0 && pawnCounts[side][x - 1] > 0;
+                    const bool hasRightNeighbour = x < 7 && pawnCounts[side][x + 1] > 0;
+                    if (!hasLeftNeighbour && !hasRightNeighbour)
+                        accumulator.Add(IsolatedPawnIndex, isWhite);
+
+                    // The enemy pawns are blocking if they are in front of this one, i.e. less advanced from their side
+                    bool isPassed = true;
+                    for (int file = std::max(x - 1, 0); file <= std::min(x + 1, 7); file++)
+                        isPassed &= leastAdvancedPawns[1 - side][file] + rank >= 7;
+                    if (isPassed)
+                        accumulator.Add(PassedPawnOffset + rank, isWhite);
+                    break;
+                }
+                case PieceType::Rook:
+                    if (pawnCounts[side][x] == 0)
+                        accumulator.Add(pawnCounts[1 - side][x] == 0 ? RookOpenFileIndex : RookSemiOpenFileIndex, isWhite);
+                    [[fallthrough]];
+                case PieceType::Queen:
+                case PieceType::Bishop:
+                case PieceType::Knight:
+                    accumulator.Add(MobilityOffset + typeIndex, isWhite, position.GetMobility(square));
+                    break;
+                case PieceType::King:
+                    break;
+            }
+        }
+
+        for (size_t side = 0; side < 2; side++)
+        {
+            const bool isWhite = side == 0;
+            for (const int count : pawnCounts[side])
+            {
+                if (count > 1)
+                    accumulator.Add(DoubledPawnIndex, isWhite, count - 1);
+            }
+            if (position.GetPieceCount(PieceType::Bishop, isWhite) >= 2)
+                accumulator.Add(BishopPairIndex, isWhite);
+        }
+
+        return std::min(phase, Evaluation::MaxPhase);
+    }
+}
+
+int Evaluation::Evaluate(const Position& position)
+{
+    PROFILE_SCOPE(ProfileStage::Evaluation);
+
+    ScoreAccumulator accumulator;
+    const int phase = EvaluateFeatures(position, accumulator);
+
+    const int score = (accumulator.middleGame * phase + accumulator.endGame * (MaxPhase - phase)) / MaxPhase;
+    return (position.isWhiteToMove ? score : -score) + Tempo;
+}
+
+void Evaluation::Trace(const Position& position, EvaluationTrace& trace)
+{
+    trace = EvaluationTrace();
+    TraceAccumulator accumulator{ trace };
+    trace.phase = EvaluateFeatures(position, accumulator);
+}
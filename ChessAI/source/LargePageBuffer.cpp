@@ -0,0 +1,181 @@
+﻿#include "LargePageBuffer.h"
+
+#include <cstdlib>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    constexpr size_t RoundUp(const size_t value, const size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+#ifdef _WIN32
+    // Large pages need the "Lock pages in memory" right, which is granted to the account but disabled in the process token
+    bool EnableLockMemoryPrivilege()
+    {
+        HANDLE token;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+            return false;
+
+        TOKEN_PRIVILEGES privileges{};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        // AdjustTokenPrivileges succeeds even if the right was not granted, which is only reported by the last error
+        const bool isEnabled = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+            && AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && GetLastError() == ERROR_SUCCESS;
+        CloseHandle(token);
+        return isEnabled;
+    }
+#elif defined(__linux__)
+    constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    // Transparent huge pages are only used for the parts of a mapping aligned on the huge page size
+    void* MapAligned(const size_t size)
+    {
+        const size_t mappedSize = size + HugePageSize;
+        void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED)
+            return nullptr;
+
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(mapped);
+        const uintptr_t alignedBegin = RoundUp(begin, HugePageSize);
+        if (alignedBegin > begin)
+            munmap(mapped, alignedBegin - begin);
+        if (const size_t tail = begin + mappedSize - (alignedBegin + size))
+            munmap(reinterpret_cast<void*>(alignedBegin + size), tail);
+        return reinterpret_cast<void*>(alignedBegin);
+    }
+
+    // madvise also succeeds when transparent huge pages are turned off, the selected mode is between brackets:
+    // "always [madvise] never"
+    bool AreTransparentHugePagesEnabled()
+    {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string modes;
+        std::getline(file, modes);
+        return modes.find("[always]") != std::string::npos || modes.find("[madvise]") != std::string::npos;
+    }
+#endif
+}
+
+LargePageBuffer::~LargePageBuffer()
+{
+    Free();
+}
+
+LargePageBuffer::LargePageBuffer(LargePageBuffer&& other) noexcept
+    : memory(std::exchange(other.memory, nullptr)), size(std::exchange(other.size, 0)), mode(std::exchange(other.mode, AllocationMode::None))
+{
+}
+
+LargePageBuffer& LargePageBuffer::operator=(LargePageBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Free();
+        memory = std::exchange(other.memory, nullptr);
+        size = std::exchange(other.size, 0);
+        mode = std::exchange(other.mode, AllocationMode::None);
+    }
+    return *this;
+}
+
+LargePageBuffer LargePageBuffer::Allocate(const size_t bytes, const bool useLargePages)
+{
+    LargePageBuffer buffer;
+    if (bytes == 0)
+        return buffer;
+
+#ifdef _WIN32
+    const size_t largePageSize = GetLargePageMinimum();
+    if (useLargePages && largePageSize && EnableLockMemoryPrivilege())
+    {
+        buffer.size = RoundUp(bytes, largePageSize);
+        buffer.memory = VirtualAlloc(nullptr, buffer.size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (buffer.memory)
+        {
+            buffer.mode = AllocationMode::HugePages;
+            return buffer;
+        }
+    }
+
+    // Large pages are often unavailable once the physical memory is fragmented
+    buffer.size = bytes;
+    buffer.memory = VirtualAlloc(nullptr, buffer.size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    buffer.mode = AllocationMode::Standard;
+#elif defined(__linux__)
+    buffer.size = RoundUp(bytes, HugePageSize);
+    if (useLargePages)
+    {
+        // Only succeeds if enough huge pages were reserved, through vm.nr_hugepages
+        buffer.memory = mmap(nullptr, buffer.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (buffer.memory != MAP_FAILED)
+        {
+            buffer.mode = AllocationMode::HugePages;
+            return buffer;
+        }
+    }
+
+    buffer.memory = MapAligned(buffer.size);
+    if (buffer.memory)
+        buffer.mode = useLargePages && madvise(buffer.memory, buffer.size, MADV_HUGEPAGE) == 0 && AreTransparentHugePagesEnabled()
+            ? AllocationMode::TransparentHugePages : AllocationMode::Standard;
+#else
+    buffer.size = bytes;
+    buffer.memory = std::calloc(bytes, 1);
+    buffer.mode = AllocationMode::Standard;
+#endif
+
+    if (!buffer.memory)
+    {
+        buffer.size = 0;
+        buffer.mode = AllocationMode::None;
+    }
+    return buffer;
+}
+
+const char* LargePageBuffer::GetName(const AllocationMode mode)
+{
+    switch (mode)
+    {
+        case AllocationMode::None:
+            return "not allocated";
+        case AllocationMode::Standard:
+            return "regular pages";
+        case AllocationMode::TransparentHugePages:
+            return "transparent huge pages";
+        case AllocationMode::HugePages:
+            return "huge pages";
+    }
+    return "";
+}
+
+void LargePageBuffer::Free()
+{
+    if (!memory)
+        return;
+
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    munmap(memory, size);
+#else
+    std::free(memory);
+#endif
+    memory = nullptr;
+    size = 0;
+    mode = AllocationMode::None;
+}
@@ -0,0 +1,44 @@
+﻿#include "Move.h"
+
+std::string Move::ToUci() const
+{
+    if (IsNull())
+        return "0000";
+
+    std::string uci;
+    uci += static_cast<char>('a' + GetSquareX(GetFrom()));
+    uci += static_cast<char>('8' - GetSquareY(GetFrom()));
+    uci += static_cast<char>('a' + GetSquareX(GetTo()));
+    uci += static_cast<char>('8' - GetSquareY(GetTo()));
+
+    if (GetFlag() == MoveFlag::Promotion)
+    {
+        switch (GetPromotion())
+        {
+            case PieceType::Rook:
+                uci += 'r';
+                break;
+            case PieceType::Bishop:
+                uci += 'b';
+                break;
+            case PieceType::Knight:
+                uci += 'n';
+                break;
+            default:
+                uci += 'q';
+                break;
+        }
+    }
+
+    return uci;
+}
+
+bool MoveList::Contains(const Move move) const
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (moves[i] == move)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,133 @@
+﻿#include "MovePicker.h"
+
+#include <utility>
+
+#include "Position.h"
+#include "Profiler.h"
+
+namespace
+{
+    // Indexed by PieceType
+    constexpr std::array VictimValues = { 0, 900, 500, 330, 320, 100 };
+    constexpr std::array AttackerOrder = { 5, 4, 3, 2, 1, 0 };
+}
+
+MovePicker::MovePicker(const Position& position, const Move ttMove, const std::array<Move, 2>& killers, const HistoryTable& history,
+    const bool skipQuiets)
+    : position(position), history(history), ttMove(ttMove), killers(killers), skipQuiets(skipQuiets)
+{
+    if (ttMove.IsNull() || !position.IsPseudoLegal(ttMove) || (skipQuiets && !position.IsNoisy(ttMove)))
+        this->ttMove = Move();
+}
+
+Move MovePicker::Next()
+{
+    PROFILE_SCOPE(ProfileStage::MovePicker);
+
+    while (true)
+    {
+        switch (stage)
+        {
+            case Stage::TtMove:
+                stage = Stage::GenerateNoisy;
+                if (!ttMove.IsNull())
+                    return ttMove;
+                break;
+
+            case Stage::GenerateNoisy:
+                position.GenerateMoves(moves, MoveGeneration::Noisy);
+                ScoreNoisy();
+                index = 0;
+                stage = Stage::Noisy;
+                break;
+
+            case Stage::Noisy:
+                if (const Move move = PickBest(); !move.IsNull())
+                    return move;
+                stage = skipQuiets ? Stage::Done : Stage::Killers;
+                break;
+
+            case Stage::Killers:
+                while (killerIndex < killers.size())
+                {
+                    const Move killer = killers[killerIndex++];
+                    if (killer.IsNull() || killer == ttMove || position.IsNoisy(killer) || !position.IsPseudoLegal(killer))
+                        continue;
+                    return killer;
+                }
+                stage = Stage::GenerateQuiet;
+                break;
+
+            case Stage::GenerateQuiet:
+                moves.Clear();
+                position.GenerateMoves(moves, MoveGeneration::Quiet);
+                ScoreQuiet();
+                index = 0;
+                stage = Stage::Quiet;
+                break;
+
+            case Stage::Quiet:
+                if (const Move move = PickBest(); !move.IsNull())
+                    return move;
+                stage = Stage::Done;
+                break;
+
+            case Stage::Done:
+                return {};
+        }
+    }
+}
+
+Move MovePicker::PickBest()
+{
+    while (index < moves.GetSize())
+    {
+        // Selection sort step: the remaining moves are rarely all needed after a cutoff
+        size_t best = index;
+        for (size_t i = index + 1; i < moves.GetSize(); i++)
+        {
+            if (scores[i] > scores[best])
+                best = i;
+        }
+        std::swap(moves[index], moves[best]);
+        std::swap(scores[index], scores[best]);
+
+        const Move move = moves[index++];
+        if (!IsAlreadyPicked(move))
+            return move;
+    }
+    return {};
+}
+
+bool MovePicker::IsAlreadyPicked(const Move move) const
+{
+    if (move == ttMove)
+        return true;
+    return stage == Stage::Quiet && (move == killers[0] || move == killers[1]);
+}
+
+void MovePicker::ScoreNoisy()
+{
+    for (size_t i = 0; i < moves.GetSize(); i++)
+    {
+        const Move move = moves[i];
+        const uint8_t victim = position.board[move.GetTo()];
+        const size_t attackerType = static_cast<size_t>(GetPieceType(position.board[move.GetFrom()]));
+
+        int score = AttackerOrder[attackerType];
+        if (victim != NoPiece)
+            score += VictimValues[static_cast<size_t>(GetPieceType(victim))] * 8;
+        else if (move.GetFlag() == MoveFlag::EnPassant)
+            score += VictimValues[static_cast<size_t>(PieceType::Pawn)] * 8;
+        if (move.GetFlag() == MoveFlag::Promotion)
+            score += move.GetPromotion() == PieceType::Queen ? 8000 : -16000;
+        scores[i] = score;
+    }
+}
+
+void MovePicker::ScoreQuiet()
+{
+    const size_t color = position.isWhiteToMove ? 0 : 1;
+    for (size_t i = 0; i < moves.GetSize(); i++)
+        scores[i] = history[color][moves[i].GetFrom()][moves[i].GetTo()];
+}
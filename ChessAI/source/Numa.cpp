@@ -0,0 +1,122 @@
+﻿#include "Numa.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    using NodeAffinity = GROUP_AFFINITY;
+
+    std::vector<NodeAffinity> DetectNodes()
+    {
+        std::vector<NodeAffinity> nodes;
+        ULONG highestNode = 0;
+        if (!GetNumaHighestNodeNumber(&highestNode))
+            return nodes;
+
+        for (USHORT node = 0; node <= highestNode; node++)
+        {
+            GROUP_AFFINITY affinity{};
+            if (GetNumaNodeProcessorMaskEx(node, &affinity) && affinity.Mask != 0)
+                nodes.push_back(affinity);
+        }
+        return nodes;
+    }
+#elif defined(__linux__)
+    using NodeAffinity = std::vector<int>;
+
+    // Parses lists such as "0-7,16-23"
+    std::vector<int> ParseList(const std::string& list)
+    {
+        std::vector<int> values;
+        std::stringstream stream(list);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            if (range.empty() || range == "\n")
+                continue;
+            const size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int value = first; value <= last; value++)
+                values.push_back(value);
+        }
+        return values;
+    }
+
+    std::string ReadLine(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    std::vector<NodeAffinity> DetectNodes()
+    {
+        std::vector<NodeAffinity> nodes;
+        for (const int node : ParseList(ReadLine("/sys/devices/system/node/online")))
+        {
+            std::vector<int> processors = ParseList(ReadLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            if (!processors.empty())
+                nodes.push_back(std::move(processors));
+        }
+        return nodes;
+    }
+#else
+    using NodeAffinity = int;
+
+    std::vector<NodeAffinity> DetectNodes()
+    {
+        return {};
+    }
+#endif
+
+    const std::vector<NodeAffinity>& GetNodes()
+    {
+        static const std::vector<NodeAffinity> nodes = DetectNodes();
+        return nodes;
+    }
+}
+
+size_t Numa::GetNodeCount()
+{
+    return std::max<size_t>(GetNodes().size(), 1);
+}
+
+bool Numa::BindThisThread(const size_t node)
+{
+    const std::vector<NodeAffinity>& nodes = GetNodes();
+    if (node >= nodes.size())
+        return false;
+
+#ifdef _WIN32
+    return SetThreadGroupAffinity(GetCurrentThread(), &nodes[node], nullptr) != 0;
+#elif defined(__linux__)
+    cpu_set_t processors;
+    CPU_ZERO(&processors);
+    for (const int processor : nodes[node])
+    {
+        if (processor < CPU_SETSIZE)
+            CPU_SET(processor, &processors);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(processors), &processors) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,923 @@
+﻿#include "Position.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "Profiler.h"
+
+namespace
+{
+    struct SquareList
+    {
+        std::array<uint8_t, 8> squares{};
+        uint8_t size = 0;
+
+        [[nodiscard]] const uint8_t* begin() const { return squares.data(); }
+        [[nodiscard]] const uint8_t* end() const { return squares.data() + size; }
+    };
+
+    // The first four directions are orthogonal, the last four are diagonal
+    constexpr std::array<std::array<int, 2>, 8> Directions = {{
+        { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 },
+        { 1, -1 }, { -1, -1 }, { 1, 1 }, { -1, 1 }
+    }};
+
+    constexpr std::array<std::array<int, 2>, 8> KnightOffsets = {{
+        { 1, 2 }, { 1, -2 }, { 2, 1 }, { 2, -1 },
+        { -1, 2 }, { -1, -2 }, { -2, 1 }, { -2, -1 }
+    }};
+
+    struct AttackTables
+    {
+        std::array<SquareList, SquareCount> knight;
+        std::array<SquareList, SquareCount> king;
+        std::array<std::array<SquareList, 8>, SquareCount> rays;
+    };
+
+    constexpr bool IsOnBoard(const int x, const int y) { return x >= 0 && x < 8 && y >= 0 && y < 8; }
+
+    AttackTables BuildAttackTables()
+    {
+        AttackTables tables;
+        for (uint8_t square = 0; square < SquareCount; square++)
+        {
+            const int x = GetSquareX(square);
+            const int y = GetSquareY(square);
+
+            for (const auto& [dx, dy] : KnightOffsets)
+            {
+                if (IsOnBoard(x + dx, y + dy))
+                {
+                    SquareList& list = tables.knight[square];
+                    list.squares[list.size++] = MakeSquare(x + dx, y + dy);
+                }
+            }
+
+            for (size_t direction = 0; direction < Directions.size(); direction++)
+            {
+                const auto& [dx, dy] = Directions[direction];
+                if (IsOnBoard(x + dx, y + dy))
+                {
+                    SquareList& list = tables.king[square];
+                    list.squares[list.size++] = MakeSquare(x + dx, y + dy);
+                }
+
+                SquareList& ray = tables.rays[square][direction];
+                for (int distance = 1; IsOnBoard(x + dx * distance, y + dy * distance); distance++)
+                    ray.squares[ray.size++] = MakeSquare(x + dx * distance, y + dy * distance);
+            }
+        }
+        return tables;
+    }
+
+    const AttackTables Attacks = BuildAttackTables();
+
+    constexpr uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    struct ZobristKeys
+    {
+        std::array<std::array<uint64_t, SquareCount>, 13> pieces{};
+        std::array<uint64_t, 16> castling{};
+        std::array<uint64_t, 8> enPassant{};
+        uint64_t side = 0;
+    };
+
+    constexpr ZobristKeys BuildZobristKeys()
+    {
+        ZobristKeys keys;
+        uint64_t state = 0x4368657373414921ull;
+        for (size_t piece = 1; piece < keys.pieces.size(); piece++)
+        {
+            for (uint64_t& key : keys.pieces[piece])
+                key = SplitMix64(state);
+        }
+        for (uint64_t& key : keys.castling)
+            key = SplitMix64(state);
+        for (uint64_t& key : keys.enPassant)
+            key = SplitMix64(state);
+        keys.side = SplitMix64(state);
+        return keys;
+    }
+
+    constexpr ZobristKeys Zobrist = BuildZobristKeys();
+
+    constexpr std::array<uint8_t, SquareCount> BuildCastlingMasks()
+    {
+        std::array<uint8_t, SquareCount> masks{};
+        masks.fill(0xF);
+        masks[MakeSquare(4, 7)] &= ~(WhiteKingSide | WhiteQueenSide);
+        masks[MakeSquare(7, 7)] &= ~WhiteKingSide;
+        masks[MakeSquare(0, 7)] &= ~WhiteQueenSide;
+        masks[MakeSquare(4, 0)] &= ~(BlackKingSide | BlackQueenSide);
+        masks[MakeSquare(7, 0)] &= ~BlackKingSide;
+        masks[MakeSquare(0, 0)] &= ~BlackQueenSide;
+        return masks;
+    }
+
+    constexpr std::array<uint8_t, SquareCount> CastlingMasks = BuildCastlingMasks();
+
+    constexpr std::string_view PieceCharacters = " KQRBNPkqrbnp";
+    // Piece letters of the algebraic notation, indexed by PieceType
+    constexpr std::string_view SanCharacters = "KQRBN";
+}
+
+bool Position::SetFen(const std::string_view fen)
+{
+    Clear();
+
+    std::istringstream stream{ std::string(fen) };
+    std::string placement, side, castling, enPassant;
+    stream >> placement >> side >> castling >> enPassant;
+    if (placement.empty())
+        return false;
+
+    int x = 0, y = 0;
+    for (const char c : placement)
+    {
+        if (c == '/')
+        {
+            x = 0;
+            y++;
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            x += c - '0';
+        }
+        else
+        {
+            const size_t index = PieceCharacters.find(c);
+            if (index == std::string_view::npos || index == 0 || !IsOnBoard(x, y))
+                return false;
+            // Pawns on the back ranks would make the move generator step off the board
+            if (GetPieceType(static_cast<uint8_t>(index)) == PieceType::Pawn && (y == 0 || y == 7))
+                return false;
+            AddPiece(static_cast<uint8_t>(index), MakeSquare(x, y));
+            x++;
+        }
+    }
+
+    if (kingSquares[0] == NoSquare || kingSquares[1] == NoSquare)
+        return false;
+
+    if (side != "w" && side != "b")
+        return false;
+    isWhiteToMove = side == "w";
+
+    for (const char c : castling)
+    {
+        switch (c)
+        {
+            case 'K':
+                castlingRights |= WhiteKingSide;
+                break;
+            case 'Q':
+                castlingRights |= WhiteQueenSide;
+                break;
+            case 'k':
+                castlingRights |= BlackKingSide;
+                break;
+            case 'q':
+                castlingRights |= BlackQueenSide;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // The square is only kept if a pawn just crossed it, otherwise the capture would remove a piece that is not there
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && enPassant[1] == (isWhiteToMove ? '6' : '3'))
+    {
+        const int x = enPassant[0] - 'a';
+        const int y = '8' - enPassant[1];
+        const uint8_t pawnSquare = MakeSquare(x, isWhiteToMove ? y + 1 : y - 1);
+        if (board[MakeSquare(x, y)] == NoPiece && board[pawnSquare] == MakePiece(PieceType::Pawn, !isWhiteToMove))
+            enPassantSquare = MakeSquare(x, y);
+    }
+
+    int halfmove = 0, fullmove = 1;
+    if (stream >> halfmove)
+        stream >> fullmove;
+    halfmoveClock = static_cast<uint16_t>(std::max(halfmove, 0));
+    fullmoveNumber = static_cast<uint16_t>(std::max(fullmove, 1));
+
+    RefreshHash();
+    return true;
+}
+
+std::string Position::GetFen() const
+{
+    std::string fen;
+    for (int y = 0; y < 8; y++)
+    {
+        int empty = 0;
+        for (int x = 0; x < 8; x++)
+        {
+            const uint8_t piece = board[MakeSquare(x, y)];
+            if (piece == NoPiece)
+            {
+                empty++;
+                continue;
+            }
+            if (empty)
+                fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += PieceCharacters[piece];
+        }
+        if (empty)
+            fen += static_cast<char>('0' + empty);
+        if (y < 7)
+            fen += '/';
+    }
+
+    fen += isWhiteToMove ? " w " : " b ";
+
+    if (castlingRights & WhiteKingSide)
+        fen += 'K';
+    if (castlingRights & WhiteQueenSide)
+        fen += 'Q';
+    if (castlingRights & BlackKingSide)
+        fen += 'k';
+    if (castlingRights & BlackQueenSide)
+        fen += 'q';
+    if (!castlingRights)
+        fen += '-';
+
+    if (enPassantSquare == NoSquare)
+    {
+        fen += " -";
+    }
+    else
+    {
+        fen += ' ';
+        fen += static_cast<char>('a' + GetSquareX(enPassantSquare));
+        fen += static_cast<char>('8' - GetSquareY(enPassantSquare));
+    }
+
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+    return fen;
+}
+
+void Position::Clear()
+{
+    *this = Position();
+}
+
+void Position::AddPiece(const uint8_t piece, const uint8_t square)
+{
+    if (board[square] != NoPiece)
+        RemovePiece(square);
+    PutPiece(piece, square);
+}
+
+void Position::RefreshHash()
+{
+    hash = 0;
+    for (uint8_t square = 0; square < SquareCount; square++)
+    {
+        if (board[square] != NoPiece)
+            hash ^= Zobrist.pieces[board[square]][square];
+    }
+    hash ^= Zobrist.castling[castlingRights];
+    if (enPassantSquare != NoSquare)
+        hash ^= Zobrist.enPassant[GetSquareX(enPassantSquare)];
+    if (!isWhiteToMove)
+        hash ^= Zobrist.side;
+}
+
+bool Position::MakeMove(const Move move, UndoInfo& undo)
+{
+    const uint8_t from = move.GetFrom();
+    const uint8_t to = move.GetTo();
+    const uint8_t piece = board[from];
+    const bool isWhite = isWhiteToMove;
+
+    undo.hash = hash;
+    undo.captured = board[to];
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    hash ^= Zobrist.castling[castlingRights];
+    if (enPassantSquare != NoSquare)
+        hash ^= Zobrist.enPassant[GetSquareX(enPassantSquare)];
+    enPassantSquare = NoSquare;
+    halfmoveClock++;
+
+    switch (move.GetFlag())
+    {
+        case MoveFlag::EnPassant:
+        {
+            const uint8_t capturedSquare = MakeSquare(GetSquareX(to), GetSquareY(from));
+            undo.captured = board[capturedSquare];
+            RemovePiece(capturedSquare);
+            MovePiece(from, to);
+            halfmoveClock = 0;
+            break;
+        }
+        case MoveFlag::Castle:
+        {
+            const int y = GetSquareY(from);
+            const bool isKingSide = GetSquareX(to) == 6;
+            MovePiece(from, to);
+            MovePiece(MakeSquare(isKingSide ? 7 : 0, y), MakeSquare(isKingSide ? 5 : 3, y));
+            break;
+        }
+        case MoveFlag::Promotion:
+            if (undo.captured != NoPiece)
+                RemovePiece(to);
+            RemovePiece(from);
+            PutPiece(MakePiece(move.GetPromotion(), isWhite), to);
+            halfmoveClock = 0;
+            break;
+        case MoveFlag::Normal:
+            if (undo.captured != NoPiece)
+            {
+                RemovePiece(to);
+                halfmoveClock = 0;
+            }
+            MovePiece(from, to);
+            if (GetPieceType(piece) == PieceType::Pawn)
+            {
+                halfmoveClock = 0;
+                if (std::abs(GetSquareY(to) - GetSquareY(from)) == 2)
+                    enPassantSquare = MakeSquare(GetSquareX(from), (GetSquareY(from) + GetSquareY(to)) / 2);
+            }
+            break;
+    }
+
+    castlingRights &= CastlingMasks[from] & CastlingMasks[to];
+    hash ^= Zobrist.castling[castlingRights];
+    if (enPassantSquare != NoSquare)
+        hash ^= Zobrist.enPassant[GetSquareX(enPassantSquare)];
+
+    if (!isWhite)
+        fullmoveNumber++;
+    isWhiteToMove = !isWhiteToMove;
+    hash ^= Zobrist.side;
+
+    if (IsSquareAttacked(kingSquares[isWhite ? 0 : 1], !isWhite))
+    {
+        UnmakeMove(move, undo);
+        return false;
+    }
+    return true;
+}
+
+void Position::UnmakeMove(const Move move, const UndoInfo& undo)
+{
+    isWhiteToMove = !isWhiteToMove;
+    if (!isWhiteToMove)
+        fullmoveNumber--;
+
+    const uint8_t from = move.GetFrom();
+    const uint8_t to = move.GetTo();
+
+    switch (move.GetFlag())
+    {
+        case MoveFlag::EnPassant:
+            MovePiece(to, from);
+            PutPiece(undo.captured, MakeSquare(GetSquareX(to), GetSquareY(from)));
+            break;
+        case MoveFlag::Castle:
+        {
+            const int y = GetSquareY(from);
+            const bool isKingSide = GetSquareX(to) == 6;
+            MovePiece(to, from);
+            MovePiece(MakeSquare(isKingSide ? 5 : 3, y), MakeSquare(isKingSide ? 7 : 0, y));
+            break;
+        }
+        case MoveFlag::Promotion:
+            RemovePiece(to);
+            PutPiece(MakePiece(PieceType::Pawn, isWhiteToMove), from);
+            if (undo.captured != NoPiece)
+                PutPiece(undo.captured, to);
+            break;
+        case MoveFlag::Normal:
+            MovePiece(to, from);
+            if (undo.captured != NoPiece)
+                PutPiece(undo.captured, to);
+            break;
+    }
+
+    hash = undo.hash;
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+}
+
+void Position::MakeNullMove(UndoInfo& undo)
+{
+    undo.hash = hash;
+    undo.captured = NoPiece;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    if (enPassantSquare != NoSquare)
+        hash ^= Zobrist.enPassant[GetSquareX(enPassantSquare)];
+    enPassantSquare = NoSquare;
+    halfmoveClock++;
+    isWhiteToMove = !isWhiteToMove;
+    hash ^= Zobrist.side;
+}
+
+void Position::UnmakeNullMove(const UndoInfo& undo)
+{
+    isWhiteToMove = !isWhiteToMove;
+    hash = undo.hash;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+}
+
+void Position::GenerateMoves(MoveList& result, const MoveGeneration generation) const
+{
+    PROFILE_SCOPE(ProfileStage::MoveGeneration);
+    [[maybe_unused]] const size_t previousSize = result.GetSize();
+
+    for (uint8_t square = 0; square < SquareCount; square++)
+    {
+        const uint8_t piece = board[square];
+        if (piece != NoPiece && IsWhitePiece(piece) == isWhiteToMove)
+            GeneratePieceMoves(square, result, generation);
+    }
+
+    if (generation != MoveGeneration::Noisy)
+        GenerateCastlingMoves(result);
+
+    PROFILE_ADD(ProfileCounter::GeneratedMoves, result.GetSize() - previousSize);
+}
+
+void Position::GenerateLegalMoves(MoveList& result) const
+{
+    MoveList pseudoLegalMoves;
+    GenerateMoves(pseudoLegalMoves);
+
+    Position copy = *this;
+    for (const Move move : pseudoLegalMoves)
+    {
+        UndoInfo undo;
+        if (copy.MakeMove(move, undo))
+        {
+            copy.UnmakeMove(move, undo);
+            result.Add(move);
+        }
+    }
+}
+
+bool Position::IsPseudoLegal(const Move move) const
+{
+    if (move.IsNull())
+        return false;
+
+    const uint8_t piece = board[move.GetFrom()];
+    if (piece == NoPiece || IsWhitePiece(piece) != isWhiteToMove)
+        return false;
+
+    MoveList moves;
+    if (move.GetFlag() == MoveFlag::Castle)
+        GenerateCastlingMoves(moves);
+    else
+        GeneratePieceMoves(move.GetFrom(), moves, MoveGeneration::All);
+    return moves.Contains(move);
+}
+
+bool Position::IsLegal(const Move move) const
+{
+    if (!IsPseudoLegal(move))
+        return false;
+
+    Position copy = *this;
+    UndoInfo undo;
+    return copy.MakeMove(move, undo);
+}
+
+bool Position::IsNoisy(const Move move) const
+{
+    return move.GetFlag() == MoveFlag::Promotion || move.GetFlag() == MoveFlag::EnPassant || board[move.GetTo()] != NoPiece;
+}
+
+Move Position::ParseUci(const std::string_view uci) const
+{
+    MoveList moves;
+    GenerateLegalMoves(moves);
+    for (const Move move : moves)
+    {
+        if (move.ToUci() == uci)
+            return move;
+    }
+    return {};
+}
+
+Move Position::ParseSan(std::string_view san) const
+{
+    while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos)
+        san.remove_suffix(1);
+
+    MoveList moves;
+    GenerateLegalMoves(moves);
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+    {
+        const bool isKingSide = san.size() == 3;
+        for (const Move move : moves)
+        {
+            if (move.GetFlag() == MoveFlag::Castle && (GetSquareX(move.GetTo()) == 6) == isKingSide)
+                return move;
+        }
+        return {};
+    }
+
+    PieceType type = PieceType::Pawn;
+    if (!san.empty() && SanCharacters.find(san.front()) != std::string_view::npos)
+    {
+        type = static_cast<PieceType>(SanCharacters.find(san.front()));
+        san.remove_prefix(1);
+    }
+
+    // Promotions are written e8=Q, sometimes e8Q
+    bool isPromotion = false;
+    PieceType promotion = PieceType::Queen;
+    if (san.size() >= 3 && SanCharacters.find(san.back()) != std::string_view::npos && san.back() != 'K')
+    {
+        isPromotion = true;
+        promotion = static_cast<PieceType>(SanCharacters.find(san.back()));
+        san.remove_suffix(san[san.size() - 2] == '=' ? 2 : 1);
+    }
+
+    if (san.size() < 2)
+        return {};
+    const char toFile = san[san.size() - 2];
+    const char toRank = san[san.size() - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8')
+        return {};
+    const uint8_t to = MakeSquare(toFile - 'a', '8' - toRank);
+
+    // Whatever is left between the piece and the destination is the capture sign and the disambiguation
+    int fromX = -1, fromY = -1;
+    for (const char c : san.substr(0, san.size() - 2))
+    {
+        if (c >= 'a' && c <= 'h')
+            fromX = c - 'a';
+        else if (c >= '1' && c <= '8')
+            fromY = '8' - c;
+        else if (c != 'x')
+            return {};
+    }
+
+    Move found;
+    for (const Move move : moves)
+    {
+        if (move.GetTo() != to || GetPieceType(board[move.GetFrom()]) != type || move.GetFlag() == MoveFlag::Castle)
+            continue;
+        if ((fromX >= 0 && GetSquareX(move.GetFrom()) != fromX) || (fromY >= 0 && GetSquareY(move.GetFrom()) != fromY))
+            continue;
+        if ((move.GetFlag() == MoveFlag::Promotion) != isPromotion || (isPromotion && move.GetPromotion() != promotion))
+            continue;
+
+        // Ambiguous moves are rejected rather than guessed
+        if (!found.IsNull())
+            return {};
+        found = move;
+    }
+    return found;
+}
+
+std::string Position::ToSan(const Move move) const
+{
+    std::string san;
+    const PieceType type = GetPieceType(board[move.GetFrom()]);
+    const int toX = GetSquareX(move.GetTo());
+
+    if (move.GetFlag() == MoveFlag::Castle)
+    {
+        san = toX == 6 ? "O-O" : "O-O-O";
+    }
+    else
+    {
+        const bool isCapture = board[move.GetTo()] != NoPiece || move.GetFlag() == MoveFlag::EnPassant;
+        if (type == PieceType::Pawn)
+        {
+            if (isCapture)
+                san += static_cast<char>('a' + GetSquareX(move.GetFrom()));
+        }
+        else
+        {
+            san += SanCharacters[static_cast<size_t>(type)];
+
+            // Only the coordinates needed to tell the moving piece from the other ones of its type reaching the same square
+            MoveList moves;
+            GenerateLegalMoves(moves);
+            bool isAmbiguous = false, sharesFile = false, sharesRank = false;
+            for (const Move other : moves)
+            {
+                if (other.GetTo() != move.GetTo() || other.GetFrom() == move.GetFrom() || board[other.GetFrom()] != board[move.GetFrom()])
+                    continue;
+                isAmbiguous = true;
+                sharesFile |= GetSquareX(other.GetFrom()) == GetSquareX(move.GetFrom());
+                sharesRank |= GetSquareY(other.GetFrom()) == GetSquareY(move.GetFrom());
+            }
+            if (isAmbiguous && (!sharesFile || sharesRank))
+                san += static_cast<char>('a' + GetSquareX(move.GetFrom()));
+            if (isAmbiguous && sharesFile)
+                san += static_cast<char>('8' - GetSquareY(move.GetFrom()));
+        }
+
+        if (isCapture)
+            san += 'x';
+        san += static_cast<char>('a' + toX);
+        san += static_cast<char>('8' - GetSquareY(move.GetTo()));
+
+        if (move.GetFlag() == MoveFlag::Promotion)
+        {
+            san += '=';
+            san += SanCharacters[static_cast<size_t>(move.GetPromotion())];
+        }
+    }
+
+    Position next = *this;
+    UndoInfo undo;
+    if (next.MakeMove(move, undo) && next.IsInCheck())
+    {
+        MoveList replies;
+        next.GenerateLegalMoves(replies);
+        san += replies.GetSize() == 0 ? '#' : '+';
+    }
+    return san;
+}
+
+bool Position::IsSquareAttacked(const uint8_t square, const bool byWhite) const
+{
+    const int x = GetSquareX(square);
+    const int y = GetSquareY(square);
+
+    // White pawns move towards y = 0, so they attack from the row below the square
+    const int pawnY = byWhite ? y + 1 : y - 1;
+    const uint8_t pawn = MakePiece(PieceType::Pawn, byWhite);
+    if (pawnY >= 0 && pawnY < 8)
+    {
+        if (x > 0 && board[MakeSquare(x - 1, pawnY)] == pawn)
+            return true;
+        if (x < 7 && board[MakeSquare(x + 1, pawnY)] == pawn)
+            return true;
+    }
+
+    const uint8_t knight = MakePiece(PieceType::Knight, byWhite);
+    for (const uint8_t target : Attacks.knight[square])
+    {
+        if (board[target] == knight)
+            return true;
+    }
+
+    const uint8_t king = MakePiece(PieceType::King, byWhite);
+    for (const uint8_t target : Attacks.king[square])
+    {
+        if (board[target] == king)
+            return true;
+    }
+
+    const uint8_t queen = MakePiece(PieceType::Queen, byWhite);
+    for (size_t direction = 0; direction < Directions.size(); direction++)
+    {
+        const uint8_t slider = MakePiece(direction < 4 ? PieceType::Rook : PieceType::Bishop, byWhite);
+        for (const uint8_t target : Attacks.rays[square][direction])
+        {
+            const uint8_t piece = board[target];
+            if (piece == NoPiece)
+                continue;
+            if (piece == slider || piece == queen)
+                return true;
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool Position::IsInCheck() const
+{
+    return IsSquareAttacked(kingSquares[isWhiteToMove ? 0 : 1], !isWhiteToMove);
+}
+
+bool Position::IsInsufficientMaterial() const
+{
+    for (size_t color = 0; color < 2; color++)
+    {
+        if (pieceCounts[color][static_cast<size_t>(PieceType::Pawn)] || pieceCounts[color][static_cast<size_t>(PieceType::Rook)]
+            || pieceCounts[color][static_cast<size_t>(PieceType::Queen)])
+            return false;
+    }
+
+    const int minorPieces = pieceCounts[0][static_cast<size_t>(PieceType::Knight)] + pieceCounts[0][static_cast<size_t>(PieceType::Bishop)]
+        + pieceCounts[1][static_cast<size_t>(PieceType::Knight)] + pieceCounts[1][static_cast<size_t>(PieceType::Bishop)];
+    return minorPieces <= 1;
+}
+
+bool Position::HasNonPawnMaterial(const bool isWhite) const
+{
+    const std::array<uint8_t, 6>& counts = pieceCounts[isWhite ? 0 : 1];
+    return counts[static_cast<size_t>(PieceType::Queen)] || counts[static_cast<size_t>(PieceType::Rook)]
+        || counts[static_cast<size_t>(PieceType::Bishop)] || counts[static_cast<size_t>(PieceType::Knight)];
+}
+
+int Position::GetMobility(const uint8_t square) const
+{
+    const uint8_t piece = board[square];
+    const bool isWhite = IsWhitePiece(piece);
+    const auto isReachable = [&](const uint8_t to) { return board[to] == NoPiece || IsWhitePiece(board[to]) != isWhite; };
+
+    int mobility = 0;
+    switch (GetPieceType(piece))
+    {
+        case PieceType::Knight:
+            for (const uint8_t to : Attacks.knight[square])
+                mobility += isReachable(to);
+            break;
+        case PieceType::Queen:
+        case PieceType::Rook:
+        case PieceType::Bishop:
+        {
+            const PieceType type = GetPieceType(piece);
+            const size_t firstDirection = type == PieceType::Bishop ? 4 : 0;
+            const size_t lastDirection = type == PieceType::Rook ? 4 : 8;
+            for (size_t direction = firstDirection; direction < lastDirection; direction++)
+            {
+                for (const uint8_t to : Attacks.rays[square][direction])
+                {
+                    mobility += isReachable(to);
+                    if (board[to] != NoPiece)
+                        break;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return mobility;
+}
+
+void Position::GeneratePieceMoves(const uint8_t from, MoveList& result, const MoveGeneration generation) const
+{
+    const uint8_t piece = board[from];
+    const bool isWhite = IsWhitePiece(piece);
+
+    const auto addIfAllowed = [&](const uint8_t to)
+    {
+        const uint8_t target = board[to];
+        if (target == NoPiece)
+        {
+            if (generation != MoveGeneration::Noisy)
+                result.Add(Move(from, to));
+        }
+        else if (IsWhitePiece(target) != isWhite && generation != MoveGeneration::Quiet)
+        {
+            result.Add(Move(from, to));
+        }
+    };
+
+    switch (GetPieceType(piece))
+    {
+        case PieceType::Pawn:
+            GeneratePawnMoves(from, result, generation);
+            break;
+        case PieceType::Knight:
+            for (const uint8_t to : Attacks.knight[from])
+                addIfAllowed(to);
+            break;
+        case PieceType::King:
+            for (const uint8_t to : Attacks.king[from])
+                addIfAllowed(to);
+            break;
+        case PieceType::Queen:
+        case PieceType::Rook:
+        case PieceType::Bishop:
+        {
+            const PieceType type = GetPieceType(piece);
+            const size_t firstDirection = type == PieceType::Bishop ? 4 : 0;
+            const size_t lastDirection = type == PieceType::Rook ? 4 : 8;
+            for (size_t direction = firstDirection; direction < lastDirection; direction++)
+            {
+                for (const uint8_t to : Attacks.rays[from][direction])
+                {
+                    addIfAllowed(to);
+                    if (board[to] != NoPiece)
+                        break;
+                }
+            }
+            break;
+        }
+    }
+}
+
+void Position::GeneratePawnMoves(const uint8_t from, MoveList& result, const MoveGeneration generation) const
+{
+    const bool isWhite = IsWhitePiece(board[from]);
+    const int forward = isWhite ? -1 : 1;
+    const int startY = isWhite ? 6 : 1;
+    const int x = GetSquareX(from);
+    const int y = GetSquareY(from);
+
+    const uint8_t oneForward = MakeSquare(x, y + forward);
+    if (board[oneForward] == NoPiece)
+    {
+        AddPawnMove(from, oneForward, result, generation);
+
+        const uint8_t twoForward = MakeSquare(x, y + forward * 2);
+        if (y == startY && board[twoForward] == NoPiece && generation != MoveGeneration::Noisy)
+            result.Add(Move(from, twoForward));
+    }
+
+    if (generation == MoveGeneration::Quiet)
+        return;
+
+    for (const int dx : { -1, 1 })
+    {
+        if (!IsOnBoard(x + dx, y + forward))
+            continue;
+
+        const uint8_t to = MakeSquare(x + dx, y + forward);
+        const uint8_t target = board[to];
+        if (target != NoPiece && IsWhitePiece(target) != isWhite)
+            AddPawnMove(from, to, result, generation);
+        else if (to == enPassantSquare)
+            result.Add(Move(from, to, MoveFlag::EnPassant));
+    }
+}
+
+void Position::GenerateCastlingMoves(MoveList& result) const
+{
+    const bool isWhite = isWhiteToMove;
+    const uint8_t kingSide = isWhite ? WhiteKingSide : BlackKingSide;
+    const uint8_t queenSide = isWhite ? WhiteQueenSide : BlackQueenSide;
+    if (!(castlingRights & (kingSide | queenSide)))
+        return;
+
+    const int y = isWhite ? 7 : 0;
+    const uint8_t king = MakeSquare(4, y);
+    const uint8_t rook = MakePiece(PieceType::Rook, isWhite);
+    if (board[king] != MakePiece(PieceType::King, isWhite) || IsSquareAttacked(king, !isWhite))
+        return;
+
+    // The destination square is checked when the move is made
+    if (castlingRights & kingSide && board[MakeSquare(7, y)] == rook && board[MakeSquare(5, y)] == NoPiece
+        && board[MakeSquare(6, y)] == NoPiece && !IsSquareAttacked(MakeSquare(5, y), !isWhite))
+        result.Add(Move(king, MakeSquare(6, y), MoveFlag::Castle));
+
+    if (castlingRights & queenSide && board[MakeSquare(0, y)] == rook && board[MakeSquare(3, y)] == NoPiece
+        && board[MakeSquare(2, y)] == NoPiece && board[MakeSquare(1, y)] == NoPiece && !IsSquareAttacked(MakeSquare(3, y), !isWhite))
+        result.Add(Move(king, MakeSquare(2, y), MoveFlag::Castle));
+}
+
+void Position::AddPawnMove(const uint8_t from, const uint8_t to, MoveList& result, const MoveGeneration generation) const
+{
+    const int lastY = IsWhitePiece(board[from]) ? 0 : 7;
+    if (GetSquareY(to) == lastY)
+    {
+        if (generation == MoveGeneration::Quiet)
+            return;
+        for (const PieceType promotion : { PieceType::Queen, PieceType::Knight, PieceType::Rook, PieceType::Bishop })
+            result.Add(Move(from, to, MoveFlag::Promotion, promotion));
+    }
+    else if (board[to] != NoPiece ? generation != MoveGeneration::Quiet : generation != MoveGeneration::Noisy)
+    {
+        result.Add(Move(from, to));
+    }
+}
+
+void Position::PutPiece(const uint8_t piece, const uint8_t square)
+{
+    board[square] = piece;
+    hash ^= Zobrist.pieces[piece][square];
+
+    const bool isWhite = IsWhitePiece(piece);
+    const PieceType type = GetPieceType(piece);
+    pieceCounts[isWhite ? 0 : 1][static_cast<size_t>(type)]++;
+    if (type == PieceType::King)
+        kingSquares[isWhite ? 0 : 1] = square;
+}
+
+void Position::RemovePiece(const uint8_t square)
+{
+    const uint8_t piece = board[square];
+    board[square] = NoPiece;
+    hash ^= Zobrist.pieces[piece][square];
+    pieceCounts[IsWhitePiece(piece) ? 0 : 1][static_cast<size_t>(GetPieceType(piece))]--;
+}
+
+void Position::MovePiece(const uint8_t from, const uint8_t to)
+{
+    const uint8_t piece = board[from];
+    board[from] = NoPiece;
+    board[to] = piece;
+    hash ^= Zobrist.pieces[piece][from] ^ Zobrist.pieces[piece][to];
+
+    if (GetPieceType(piece) == PieceType::King)
+        kingSquares[IsWhitePiece(piece) ? 0 : 1] = to;
+}
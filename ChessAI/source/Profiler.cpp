@@ -0,0 +1,223 @@
+﻿#include "Profiler.h"
+
+#include <fstream>
+
+#include "Json.h"
+
+void ThreadProfile::Clear()
+{
+    counters.fill(0);
+    stageNanoseconds.fill(0);
+    stageCalls.fill(0);
+    iterations.clear();
+    iterationBegin = 0;
+    iterationCounters.fill(0);
+    iterationStageNanoseconds.fill(0);
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    Local().name = name;
+}
+
+void Profiler::BeginIteration()
+{
+    ThreadProfile& profile = Local();
+    profile.iterationBegin = Now();
+    profile.iterationCounters = profile.counters;
+    profile.iterationStageNanoseconds = profile.stageNanoseconds;
+}
+
+void Profiler::EndIteration(const int depth)
+{
+    ThreadProfile& profile = Local();
+
+    ProfileIteration& iteration = profile.iterations.emplace_back();
+    iteration.depth = depth;
+    iteration.beginNanoseconds = profile.iterationBegin;
+    iteration.endNanoseconds = Now();
+    for (size_t i = 0; i < ProfileCounterCount; i++)
+        iteration.counters[i] = profile.counters[i] - profile.iterationCounters[i];
+    for (size_t i = 0; i < ProfileStageCount; i++)
+        iteration.stageNanoseconds[i] = profile.stageNanoseconds[i] - profile.iterationStageNanoseconds[i];
+}
+
+void Profiler::Reset()
+{
+    std::scoped_lock lock(registryMutex);
+    for (const std::unique_ptr<ThreadProfile>& profile : profiles)
+        profile->Clear();
+}
+
+bool Profiler::ExportChromeTrace(const std::string& filepath)
+{
+    std::ofstream file(filepath);
+    if (!file)
+        return false;
+
+    std::scoped_lock lock(registryMutex);
+
+    // Timestamps of the trace event format are in microseconds
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    const auto separator = [&]() -> std::ofstream&
+    {
+        if (!first)
+            file << ',';
+        first = false;
+        file << '\n';
+        return file;
+    };
+
+    for (const std::unique_ptr<ThreadProfile>& profile : profiles)
+    {
+        const std::string name = profile->name.empty() ? "Thread " + std::to_string(profile->threadIndex) : profile->name;
+        separator() << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << profile->threadIndex
+            << R"(,"args":{"name":")" << Json::Escape(name) << "\"}}";
+
+        for (const ProfileIteration& iteration : profile->iterations)
+        {
+            separator() << R"({"name":"Depth )" << iteration.depth << R"(","ph":"X","pid":1,"tid":)" << profile->threadIndex
+                << ",\"ts\":" << static_cast<double>(iteration.beginNanoseconds) / 1000.0
+                << ",\"dur\":" << static_cast<double>(iteration.endNanoseconds - iteration.beginNanoseconds) / 1000.0
+                << ",\"args\":{";
+            for (size_t i = 0; i < ProfileCounterCount; i++)
+                file << '"' << GetName(static_cast<ProfileCounter>(i)) << "\":" << iteration.counters[i] << ',';
+            for (size_t i = 0; i < ProfileStageCount; i++)
+            {
+                file << '"' << GetName(static_cast<ProfileStage>(i)) << " (us)\":"
+                    << static_cast<double>(iteration.stageNanoseconds[i]) / 1000.0;
+                if (i + 1 < ProfileStageCount)
+                    file << ',';
+            }
+            file << "}}";
+
+            separator() << R"({"name":"Nodes","ph":"C","pid":1,"tid":)" << profile->threadIndex
+                << ",\"ts\":" << static_cast<double>(iteration.endNanoseconds) / 1000.0
+                << R"(,"args":{"nodes":)" << iteration.counters[static_cast<size_t>(ProfileCounter::Nodes)] << "}}";
+        }
+    }
+
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+bool Profiler::ExportCsv(const std::string& filepath)
+{
+    std::ofstream file(filepath);
+    if (!file)
+        return false;
+
+    std::scoped_lock lock(registryMutex);
+
+    file << "thread,iteration,depth,time_us";
+    for (size_t i = 0; i < ProfileCounterCount; i++)
+        file << ',' << GetName(static_cast<ProfileCounter>(i));
+    file << ",effective_branching_factor";
+    for (size_t i = 0; i < ProfileStageCount; i++)
+        file << ',' << GetName(static_cast<ProfileStage>(i)) << "_us";
+    file << '\n';
+
+    const auto writeRow = [&file](const uint32_t threadIndex, const std::string& iteration, const int depth, const int64_t nanoseconds,
+        const std::array<uint64_t, ProfileCounterCount>& counters, const double branchingFactor,
+        const std::array<int64_t, ProfileStageCount>& stageNanoseconds)
+    {
+        file << threadIndex << ',' << iteration << ',' << depth << ',' << static_cast<double>(nanoseconds) / 1000.0;
+        for (const uint64_t counter : counters)
+            file << ',' << counter;
+        file << ',' << branchingFactor;
+        for (const int64_t stage : stageNanoseconds)
+            file << ',' << static_cast<double>(stage) / 1000.0;
+        file << '\n';
+    };
+
+    constexpr size_t nodesIndex = static_cast<size_t>(ProfileCounter::Nodes);
+    for (const std::unique_ptr<ThreadProfile>& profile : profiles)
+    {
+        uint64_t previousNodes = 0;
+        int64_t totalNanoseconds = 0;
+        for (size_t i = 0; i < profile->iterations.size(); i++)
+        {
+            const ProfileIteration& iteration = profile->iterations[i];
+            const uint64_t nodes = iteration.counters[nodesIndex];
+            const double branchingFactor = previousNodes ? static_cast<double>(nodes) / static_cast<double>(previousNodes) : 0.0;
+            const int64_t nanoseconds = iteration.endNanoseconds - iteration.beginNanoseconds;
+            totalNanoseconds += nanoseconds;
+
+            writeRow(profile->threadIndex, std::to_string(i), iteration.depth, nanoseconds, iteration.counters, branchingFactor,
+                iteration.stageNanoseconds);
+            previousNodes = nodes;
+        }
+
+        writeRow(profile->threadIndex, "total", 0, totalNanoseconds, profile->counters, 0.0, profile->stageNanoseconds);
+    }
+
+    return static_cast<bool>(file);
+}
+
+const char* Profiler::GetName(const ProfileStage stage)
+{
+    switch (stage)
+    {
+        case ProfileStage::MoveGeneration:
+            return "move_generation";
+        case ProfileStage::Evaluation:
+            return "evaluation";
+        case ProfileStage::TranspositionTable:
+            return "transposition_table";
+        case ProfileStage::Quiescence:
+            return "quiescence";
+        case ProfileStage::MovePicker:
+            return "move_picker";
+        case ProfileStage::Count:
+            break;
+    }
+    return "unknown";
+}
+
+const char* Profiler::GetName(const ProfileCounter counter)
+{
+    switch (counter)
+    {
+        case ProfileCounter::Nodes:
+            return "nodes";
+        case ProfileCounter::QuiescenceNodes:
+            return "quiescence_nodes";
+        case ProfileCounter::BetaCutoffs:
+            return "beta_cutoffs";
+        case ProfileCounter::TtHits:
+            return "tt_hits";
+        case ProfileCounter::TtMisses:
+            return "tt_misses";
+        case ProfileCounter::GeneratedMoves:
+            return "generated_moves";
+        case ProfileCounter::Count:
+            break;
+    }
+    return "unknown";
+}
+
+ThreadProfile* Profiler::Register()
+{
+    std::scoped_lock lock(registryMutex);
+
+    // The data of an exited thread is kept and continued, its iterations remain in the exports under the same index
+    for (const std::unique_ptr<ThreadProfile>& profile : profiles)
+    {
+        if (profile->isActive)
+            continue;
+        profile->isActive = true;
+        profile->name.clear();
+        return profile.get();
+    }
+
+    ThreadProfile* profile = profiles.emplace_back(std::make_unique<ThreadProfile>()).get();
+    profile->threadIndex = static_cast<uint32_t>(profiles.size() - 1);
+    return profile;
+}
+
+void Profiler::Retire(ThreadProfile* profile)
+{
+    std::scoped_lock lock(registryMutex);
+    profile->isActive = false;
+}
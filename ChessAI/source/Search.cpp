@@ -0,0 +1,727 @@
+﻿#include "Search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "Evaluation.h"
+#include "Numa.h"
+#include "Profiler.h"
+
+namespace
+{
+    constexpr int AspirationDepth = 5;
+    constexpr int AspirationWindow = 25;
+    constexpr int MaxHistory = 16384;
+    constexpr uint64_t LimitsCheckInterval = 1024;
+
+    constexpr int NullMoveDepth = 3;
+    constexpr int ReverseFutilityDepth = 6;
+    constexpr int ReverseFutilityMargin = 80;
+    constexpr int FutilityDepth = 3;
+    constexpr int FutilityMargin = 100;
+    constexpr int RazoringDepth = 3;
+    constexpr int RazoringMargin = 250;
+    constexpr int ReductionDepth = 3;
+    // History scores are divided by this to adjust the reductions
+    constexpr int ReductionHistoryDivisor = 8192;
+
+    using ReductionTable = std::array<std::array<int, 64>, 64>;
+
+    ReductionTable BuildReductions()
+    {
+        ReductionTable reductions{};
+        for (size_t depth = 1; depth < 64; depth++)
+        {
+            for (size_t moveCount = 1; moveCount < 64; moveCount++)
+                reductions[depth][moveCount] = static_cast<int>(0.75 + std::log(depth) * std::log(moveCount) / 2.25);
+        }
+        return reductions;
+    }
+
+    // Indexed by [depth][number of moves searched]
+    const ReductionTable Reductions = BuildReductions();
+
+    // Mate scores are stored relative to the node instead of the root, so they stay correct when reached through another path
+    int ScoreToTt(const int score, const int ply)
+    {
+        if (score >= MateInMaxPly)
+            return score + ply;
+        if (score <= -MateInMaxPly)
+            return score - ply;
+        return score;
+    }
+
+    int ScoreFromTt(const int score, const int ply)
+    {
+        if (score >= MateInMaxPly)
+            return score - ply;
+        if (score <= -MateInMaxPly)
+            return score + ply;
+        return score;
+    }
+
+    void UpdateHistory(int& entry, const int bonus)
+    {
+        entry += bonus - entry * std::abs(bonus) / MaxHistory;
+    }
+}
+
+SearchThread::SearchThread(Search& search, const size_t index)
+    : search(search), index(index)
+{
+    hashHistory.reserve(1024);
+    if (IsMainThread())
+    {
+        InitializeTables();
+        return;
+    }
+
+    worker = std::make_unique<WorkerThread>();
+    StartJob([this] { InitializeTables(); });
+    WaitForJobFinished();
+}
+
+void SearchThread::StartJob(std::function<void()> newJob)
+{
+    worker->StartJob(std::move(newJob));
+}
+
+void SearchThread::StartSearching()
+{
+    StartJob([this] { IterativeDeepening(); });
+}
+
+void SearchThread::WaitForJobFinished()
+{
+    worker->WaitForJobFinished();
+}
+
+void SearchThread::InitializeTables()
+{
+    // The main thread is the caller's, it is left where the caller placed it
+    const size_t nodeCount = Numa::GetNodeCount();
+    if (!IsMainThread() && search.isThreadBindingEnabled && nodeCount > 1)
+        Numa::BindThisThread(index % nodeCount);
+    tables = std::make_unique<SearchThreadTables>();
+}
+
+void SearchThread::IterativeDeepening()
+{
+    PROFILE_THREAD_NAME("Search " + std::to_string(index));
+
+    const size_t lineCount = std::min(static_cast<size_t>(std::max(search.limits.multiPv, 1)), rootMoves.size());
+
+    // Helper threads are staggered by one ply so that they do not all search the same tree
+    for (int depth = 1 + static_cast<int>(index % 2); depth <= search.limits.depth; depth++)
+    {
+        PROFILE_ITERATION_BEGIN();
+
+        selectiveDepth = 0;
+        rootDepth = depth;
+        for (RootMove& rootMove : rootMoves)
+            rootMove.previousScore = rootMove.score;
+
+        for (pvIndex = 0; pvIndex < lineCount; pvIndex++)
+        {
+            const int previousScore = rootMoves[pvIndex].previousScore;
+            int alpha = -InfiniteScore;
+            int beta = InfiniteScore;
+            int window = AspirationWindow;
+            if (depth >= AspirationDepth && previousScore > -InfiniteScore)
+            {
+                alpha = std::max(previousScore - window, -InfiniteScore);
+                beta = std::min(previousScore + window, InfiniteScore);
+            }
+
+            while (true)
+            {
+                const int score = Negamax(alpha, beta, depth, 0);
+                // Refuted moves all score -InfiniteScore, the stable sort keeps them in their previous order
+                std::stable_sort(rootMoves.begin() + static_cast<ptrdiff_t>(pvIndex), rootMoves.end(),
+                    [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+                if (search.stopped.load(std::memory_order_relaxed))
+                    break;
+
+                if (score <= alpha)
+                    alpha = std::max(alpha - window, -InfiniteScore);
+                else if (score >= beta)
+                    beta = std::min(beta + window, InfiniteScore);
+                else
+                    break;
+                window *= 2;
+            }
+
+            if (search.stopped.load(std::memory_order_relaxed))
+                break;
+            std::stable_sort(rootMoves.begin(), rootMoves.begin() + static_cast<ptrdiff_t>(pvIndex) + 1,
+                [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+        }
+
+        PROFILE_ITERATION_END(depth);
+
+        // A partial iteration is only trusted when nothing else is available
+        if (search.stopped.load(std::memory_order_relaxed))
+        {
+            if (completedDepth == 0 && rootMoves[0].score > -InfiniteScore)
+                completedLines.assign(1, { rootMoves[0].score, rootMoves[0].pv });
+            break;
+        }
+
+        completedDepth = depth;
+        completedLines.clear();
+        for (size_t i = 0; i < lineCount; i++)
+            completedLines.push_back({ rootMoves[i].score, rootMoves[i].pv });
+
+        if (!IsMainThread())
+            continue;
+
+        if (search.onIteration)
+        {
+            SearchIteration iteration;
+            iteration.depth = depth;
+            iteration.selectiveDepth = selectiveDepth;
+            iteration.score = completedLines[0].score;
+            iteration.nodes = search.GetNodes();
+            iteration.milliseconds = search.GetElapsedMilliseconds();
+            iteration.hashfull = search.transpositionTable.GetHashfull();
+            iteration.pv = completedLines[0].pv;
+            iteration.lines = completedLines;
+            search.onIteration(iteration);
+        }
+
+        // The next iteration would most likely not finish in time
+        if (search.limits.milliseconds && search.GetElapsedMilliseconds() * 2 > search.limits.milliseconds)
+            break;
+    }
+
+    if (IsMainThread())
+        search.stopped.store(true, std::memory_order_relaxed);
+}
+
+int SearchThread::Negamax(int alpha, int beta, const int depth, const int ply)
+{
+    tables->pvLength[ply] = 0;
+
+    if (depth <= 0)
+    {
+        PROFILE_SCOPE(ProfileStage::Quiescence);
+        return Quiescence(alpha, beta, ply);
+    }
+
+    IncrementNodes();
+    if (search.stopped.load(std::memory_order_relaxed))
+        return 0;
+
+    const SearchOptions& options = search.options;
+    const bool isPvNode = beta - alpha > 1;
+    const bool isRoot = ply == 0;
+    selectiveDepth = std::max(selectiveDepth, ply);
+
+    if (!isRoot)
+    {
+        if (IsDraw())
+            return 0;
+        if (ply >= MaxPly - 1)
+            return Evaluation::Evaluate(position);
+
+        alpha = std::max(alpha, -MateScore + ply);
+        beta = std::min(beta, MateScore - ply - 1);
+        if (alpha >= beta)
+            return alpha;
+    }
+
+    const bool isInCheck = position.IsInCheck();
+
+    TtEntry ttEntry;
+    const bool ttHit = search.transpositionTable.Probe(position.hash, ttEntry);
+    if (ttHit && !isPvNode && ttEntry.depth >= depth)
+    {
+        const int ttScore = ScoreFromTt(ttEntry.score, ply);
+        if (ttEntry.bound == Bound::Exact || (ttEntry.bound == Bound::Lower && ttScore >= beta)
+            || (ttEntry.bound == Bound::Upper && ttScore <= alpha))
+            return ttScore;
+    }
+
+    const int staticEvaluation = isInCheck ? 0 : ttHit ? ttEntry.evaluation : Evaluation::Evaluate(position);
+    const size_t color = position.isWhiteToMove ? 0 : 1;
+
+    if (!isPvNode && !isInCheck)
+    {
+        // Reverse futility pruning: no quiet move is expected to lose that much
+        if (options.futilityPruning && depth <= ReverseFutilityDepth && std::abs(beta) < MateInMaxPly
+            && staticEvaluation - ReverseFutilityMargin * depth >= beta)
+            return staticEvaluation;
+
+        if (options.razoring && depth <= RazoringDepth && staticEvaluation + RazoringMargin * depth <= alpha)
+        {
+            PROFILE_SCOPE(ProfileStage::Quiescence);
+            const int score = Quiescence(alpha, beta, ply);
+            if (score <= alpha)
+                return score;
+        }
+
+        if (options.nullMovePruning && depth >= NullMoveDepth && staticEvaluation >= beta && ply >= nullMoveMinPlies[color]
+            && !(ply > 0 && isNullMove[ply - 1]) && position.HasNonPawnMaterial(position.isWhiteToMove))
+        {
+            const int reduction = 3 + depth / 6;
+
+            UndoInfo undo;
+            position.MakeNullMove(undo);
+            hashHistory.push_back(undo.hash);
+            isNullMove[ply] = true;
+            int score = -Negamax(-beta, -beta + 1, depth - 1 - reduction, ply + 1);
+            isNullMove[ply] = false;
+            hashHistory.pop_back();
+            position.UnmakeNullMove(undo);
+
+            if (search.stopped.load(std::memory_order_relaxed))
+                return 0;
+
+            if (score >= beta)
+            {
+                // Mates found after passing are not proven
+                if (score >= MateInMaxPly)
+                    score = beta;
+                if (!IsZugzwangProne())
+                    return score;
+
+                // Passing may be the best option when every move worsens the position, so the cutoff is only trusted
+                // if a reduced search where this side cannot pass confirms it. The opponent may still pass.
+                const int previousMinPly = nullMoveMinPlies[color];
+                nullMoveMinPlies[color] = ply + 3 * (depth - reduction) / 4;
+                const int verification = Negamax(beta - 1, beta, depth - reduction, ply);
+                nullMoveMinPlies[color] = previousMinPly;
+                if (verification >= beta)
+                    return score;
+            }
+        }
+    }
+
+    // Futility pruning: quiet moves are not expected to bring the static evaluation back above alpha
+    const bool canPruneQuiets = options.futilityPruning && !isPvNode && !isInCheck && depth <= FutilityDepth
+        && staticEvaluation + FutilityMargin * depth <= alpha;
+
+    MovePicker picker(position, ttHit ? ttEntry.move : Move(), tables->killers[ply], tables->history, false);
+    MoveList quietsTried;
+    const int originalAlpha = alpha;
+    int bestScore = -InfiniteScore;
+    Move bestMove;
+    int legalMoves = 0;
+
+    // The root searches its moves in rank order, skipping the MultiPV lines already found in this iteration
+    size_t rootIndex = pvIndex;
+    const auto nextMove = [&]
+    {
+        if (!isRoot)
+            return picker.Next();
+        return rootIndex < rootMoves.size() ? rootMoves[rootIndex++].move : Move();
+    };
+
+    for (Move move = nextMove(); !move.IsNull(); move = nextMove())
+    {
+        const bool isQuiet = !position.IsNoisy(move);
+
+        UndoInfo undo;
+        if (!position.MakeMove(move, undo))
+            continue;
+        legalMoves++;
+
+        const bool givesCheck = position.IsInCheck();
+        if (canPruneQuiets && isQuiet && !givesCheck && legalMoves > 1)
+        {
+            position.UnmakeMove(move, undo);
+            continue;
+        }
+
+        hashHistory.push_back(undo.hash);
+
+        // Check extensions are limited so that long checking sequences cannot explode the tree
+        const bool isExtended = options.checkExtensions && givesCheck && ply < 2 * rootDepth;
+        const int newDepth = depth - 1 + (isExtended ? 1 : 0);
+
+        int score;
+        if (legalMoves == 1)
+        {
+            score = -Negamax(-beta, -alpha, newDepth, ply + 1);
+        }
+        else
+        {
+            int reduction = 0;
+            if (options.lateMoveReductions && isQuiet && depth >= ReductionDepth && !isInCheck && !givesCheck)
+            {
+                reduction = Reductions[std::min(depth, 63)][std::min(legalMoves, 63)];
+                reduction -= tables->history[color][move.GetFrom()][move.GetTo()] / ReductionHistoryDivisor;
+                if (isPvNode || move == tables->killers[ply][0] || move == tables->killers[ply][1])
+                    reduction--;
+                reduction = std::clamp(reduction, 0, newDepth - 1);
+            }
+
+            score = -Negamax(-alpha - 1, -alpha, newDepth - reduction, ply + 1);
+            if (score > alpha && reduction > 0)
+                score = -Negamax(-alpha - 1, -alpha, newDepth, ply + 1);
+            if (score > alpha && score < beta)
+                score = -Negamax(-beta, -alpha, newDepth, ply + 1);
+        }
+
+        hashHistory.pop_back();
+        position.UnmakeMove(move, undo);
+
+        if (search.stopped.load(std::memory_order_relaxed))
+            return 0;
+
+        if (isRoot)
+            UpdateRootMove(rootIndex - 1, score, legalMoves == 1 || score > alpha);
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                bestMove = move;
+                UpdatePv(ply, move);
+
+                if (alpha >= beta)
+                {
+                    PROFILE_COUNT(ProfileCounter::BetaCutoffs);
+                    if (isQuiet)
+                        UpdateQuietStatistics(move, depth, ply, quietsTried);
+                    break;
+                }
+            }
+        }
+
+        if (isQuiet)
+            quietsTried.Add(move);
+    }
+
+    if (legalMoves == 0)
+        return isInCheck ? -MateScore + ply : 0;
+
+    // Later MultiPV lines exclude the best moves, their result is not the one of the position
+    if (!isRoot || pvIndex == 0)
+    {
+        const Bound bound = bestScore >= beta ? Bound::Lower : bestScore > originalAlpha ? Bound::Exact : Bound::Upper;
+        search.transpositionTable.Store(position.hash, bestMove, ScoreToTt(bestScore, ply), staticEvaluation, depth, bound);
+    }
+
+    return bestScore;
+}
+
+int SearchThread::Quiescence(int alpha, const int beta, const int ply)
+{
+    tables->pvLength[ply] = 0;
+
+    IncrementNodes();
+    PROFILE_COUNT(ProfileCounter::QuiescenceNodes);
+    if (search.stopped.load(std::memory_order_relaxed))
+        return 0;
+
+    selectiveDepth = std::max(selectiveDepth, ply);
+    if (ply >= MaxPly - 1)
+        return Evaluation::Evaluate(position);
+
+    const bool isPvNode = beta - alpha > 1;
+    const bool isInCheck = position.IsInCheck();
+
+    TtEntry ttEntry;
+    const bool ttHit = search.transpositionTable.Probe(position.hash, ttEntry);
+    if (ttHit && !isPvNode)
+    {
+        const int ttScore = ScoreFromTt(ttEntry.score, ply);
+        if (ttEntry.bound == Bound::Exact || (ttEntry.bound == Bound::Lower && ttScore >= beta)
+            || (ttEntry.bound == Bound::Upper && ttScore <= alpha))
+            return ttScore;
+    }
+
+    int staticEvaluation = 0;
+    int bestScore = -InfiniteScore;
+    if (!isInCheck)
+    {
+        staticEvaluation = ttHit ? ttEntry.evaluation : Evaluation::Evaluate(position);
+        bestScore = staticEvaluation;
+        if (bestScore >= beta)
+            return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+
+    // When in check every evasion is searched, so that mates are detected
+    MovePicker picker(position, ttHit ? ttEntry.move : Move(), {}, tables->history, !isInCheck);
+    const int originalAlpha = alpha;
+    Move bestMove;
+    int legalMoves = 0;
+
+    for (Move move = picker.Next(); !move.IsNull(); move = picker.Next())
+    {
+        UndoInfo undo;
+        if (!position.MakeMove(move, undo))
+            continue;
+        legalMoves++;
+        hashHistory.push_back(undo.hash);
+
+        const int score = -Quiescence(-beta, -alpha, ply + 1);
+
+        hashHistory.pop_back();
+        position.UnmakeMove(move, undo);
+
+        if (search.stopped.load(std::memory_order_relaxed))
+            return 0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                bestMove = move;
+                UpdatePv(ply, move);
+
+                if (alpha >= beta)
+                {
+                    PROFILE_COUNT(ProfileCounter::BetaCutoffs);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (isInCheck && legalMoves == 0)
+        return -MateScore + ply;
+
+    const Bound bound = bestScore >= beta ? Bound::Lower : bestScore > originalAlpha ? Bound::Exact : Bound::Upper;
+    search.transpositionTable.Store(position.hash, bestMove, ScoreToTt(bestScore, ply), staticEvaluation, 0, bound);
+
+    return bestScore;
+}
+
+bool SearchThread::IsZugzwangProne() const
+{
+    // With few pieces besides the king and pawns, passing may be the only move that does not worsen the position
+    const bool isWhite = position.isWhiteToMove;
+    return position.GetPieceCount(PieceType::Queen, isWhite) + position.GetPieceCount(PieceType::Rook, isWhite)
+        + position.GetPieceCount(PieceType::Bishop, isWhite) + position.GetPieceCount(PieceType::Knight, isWhite) <= 2;
+}
+
+bool SearchThread::IsDraw() const
+{
+    if (position.halfmoveClock >= 100 || position.IsInsufficientMaterial())
+        return true;
+
+    // Only positions with the same side to move since the last irreversible move can repeat
+    const size_t size = hashHistory.size();
+    const size_t distance = std::min<size_t>(position.halfmoveClock, size);
+    for (size_t i = 2; i <= distance; i += 2)
+    {
+        if (hashHistory[size - i] == position.hash)
+            return true;
+    }
+    return false;
+}
+
+void SearchThread::IncrementNodes()
+{
+    const uint64_t count = nodes.load(std::memory_order_relaxed) + 1;
+    nodes.store(count, std::memory_order_relaxed);
+    PROFILE_COUNT(ProfileCounter::Nodes);
+
+    if (IsMainThread() && count % LimitsCheckInterval == 0)
+        search.CheckLimits();
+}
+
+void SearchThread::UpdatePv(const int ply, const Move move)
+{
+    SearchThreadTables& data = *tables;
+    data.pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < data.pvLength[ply + 1]; i++)
+        data.pvTable[ply][i] = data.pvTable[ply + 1][i];
+    data.pvLength[ply] = std::max(data.pvLength[ply + 1], ply + 1);
+}
+
+void SearchThread::UpdateRootMove(const size_t rootIndex, const int score, const bool isBest)
+{
+    RootMove& rootMove = rootMoves[rootIndex];
+    if (!isBest)
+    {
+        rootMove.score = -InfiniteScore;
+        return;
+    }
+
+    rootMove.score = score;
+    rootMove.pv.assign(1, rootMove.move);
+    rootMove.pv.insert(rootMove.pv.end(), tables->pvTable[1].begin() + 1, tables->pvTable[1].begin() + std::max(tables->pvLength[1], 1));
+}
+
+void SearchThread::UpdateQuietStatistics(const Move bestMove, const int depth, const int ply, const MoveList& quietsTried)
+{
+    std::array<Move, 2>& killers = tables->killers[ply];
+    if (killers[0] != bestMove)
+    {
+        killers[1] = killers[0];
+        killers[0] = bestMove;
+    }
+
+    const size_t color = position.isWhiteToMove ? 0 : 1;
+    const int bonus = std::min(depth * depth, MaxHistory / 4);
+    HistoryTable& history = tables->history;
+    UpdateHistory(history[color][bestMove.GetFrom()][bestMove.GetTo()], bonus);
+    for (const Move move : quietsTried)
+        UpdateHistory(history[color][move.GetFrom()][move.GetTo()], -bonus);
+}
+
+Search::Search(const size_t hashMegabytes, const size_t threadCount)
+{
+    // The threads are bound before they clear the table for the first time
+    SetThreadCount(threadCount);
+    SetHashSize(hashMegabytes);
+}
+
+Search::~Search()
+{
+    threads.clear();
+}
+
+SearchResult Search::Run(const Position& position, const SearchLimits& searchLimits, const std::vector<uint64_t>& gameHistory)
+{
+    limits = searchLimits;
+    limits.depth = std::clamp(limits.depth, 1, MaxDepth);
+    startTime = std::chrono::steady_clock::now();
+    stopped.store(false, std::memory_order_relaxed);
+    transpositionTable.NewSearch();
+
+    // The first iteration searches the root moves in the order the move picker gives them
+    std::vector<RootMove> rootMoves;
+    TtEntry ttEntry;
+    const bool ttHit = transpositionTable.Probe(position.hash, ttEntry);
+    MovePicker picker(position, ttHit ? ttEntry.move : Move(), {}, threads[0]->tables->history, false);
+    Position copy = position;
+    for (Move move = picker.Next(); !move.IsNull(); move = picker.Next())
+    {
+        UndoInfo undo;
+        if (!copy.MakeMove(move, undo))
+            continue;
+        copy.UnmakeMove(move, undo);
+        rootMoves.emplace_back().move = move;
+    }
+
+    SearchResult result;
+    if (rootMoves.empty())
+    {
+        result.score = position.IsInCheck() ? -MateScore : 0;
+        return result;
+    }
+
+    for (const std::unique_ptr<SearchThread>& thread : threads)
+    {
+        thread->position = position;
+        thread->hashHistory.assign(gameHistory.begin(), gameHistory.end());
+        thread->nodes.store(0, std::memory_order_relaxed);
+        thread->completedDepth = 0;
+        thread->completedLines.clear();
+        thread->rootMoves = rootMoves;
+        thread->pvIndex = 0;
+        thread->tables->pvLength.fill(0);
+        thread->tables->killers = {};
+    }
+
+    for (size_t i = 1; i < threads.size(); i++)
+        threads[i]->StartSearching();
+    threads[0]->IterativeDeepening();
+    for (size_t i = 1; i < threads.size(); i++)
+        threads[i]->WaitForJobFinished();
+
+    const SearchThread& mainThread = *threads[0];
+    result.depth = mainThread.completedDepth;
+    result.nodes = GetNodes();
+    result.milliseconds = GetElapsedMilliseconds();
+    result.lines = mainThread.completedLines;
+
+    if (!result.lines.empty())
+    {
+        result.score = result.lines[0].score;
+        result.pv = result.lines[0].pv;
+        result.bestMove = result.pv.front();
+    }
+    else
+    {
+        // Stopped before the first root move could be searched
+        result.bestMove = rootMoves[0].move;
+    }
+
+    return result;
+}
+
+void Search::Stop()
+{
+    stopped.store(true, std::memory_order_relaxed);
+}
+
+void Search::SetThreadCount(const size_t count)
+{
+    threads.clear();
+    for (size_t i = 0; i < std::max<size_t>(count, 1); i++)
+        threads.push_back(std::make_unique<SearchThread>(*this, i));
+}
+
+void Search::SetHashSize(const size_t megabytes)
+{
+    hashMegabytes = megabytes;
+    transpositionTable.Resize(hashMegabytes, useLargePages);
+    ClearTranspositionTable();
+}
+
+void Search::SetLargePages(const bool enabled)
+{
+    useLargePages = enabled;
+    SetHashSize(hashMegabytes);
+}
+
+void Search::SetThreadBinding(const bool enabled)
+{
+    isThreadBindingEnabled = enabled;
+    SetThreadCount(threads.size());
+}
+
+void Search::Clear()
+{
+    ClearTranspositionTable();
+    for (const std::unique_ptr<SearchThread>& thread : threads)
+        thread->tables->history = {};
+}
+
+size_t Search::GetBoundNodeCount() const
+{
+    const size_t nodeCount = Numa::GetNodeCount();
+    return isThreadBindingEnabled && nodeCount > 1 ? std::min(nodeCount, threads.size() - 1) : 0;
+}
+
+void Search::ClearTranspositionTable()
+{
+    for (size_t i = 1; i < threads.size(); i++)
+        threads[i]->StartJob([this, i] { transpositionTable.ClearPart(i, threads.size()); });
+    transpositionTable.ClearPart(0, threads.size());
+    for (size_t i = 1; i < threads.size(); i++)
+        threads[i]->WaitForJobFinished();
+}
+
+uint64_t Search::GetNodes() const
+{
+    uint64_t total = 0;
+    for (const std::unique_ptr<SearchThread>& thread : threads)
+        total += thread->nodes.load(std::memory_order_relaxed);
+    return total;
+}
+
+int64_t Search::GetElapsedMilliseconds() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Search::CheckLimits()
+{
+    if ((limits.milliseconds && GetElapsedMilliseconds() >= limits.milliseconds)
+        || (limits.nodes && GetNodes() >= limits.nodes)
+        || (limits.stopCondition && limits.stopCondition()))
+        stopped.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,121 @@
+﻿#include "TranspositionTable.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <new>
+
+#include "Profiler.h"
+
+TranspositionTable::TranspositionTable(const size_t megabytes, const bool useLargePages)
+{
+    Resize(megabytes, useLargePages);
+    Clear();
+}
+
+void TranspositionTable::Resize(const size_t megabytes, const bool useLargePages)
+{
+    const size_t requestedSlots = std::max<size_t>(megabytes * 1024 * 1024 / sizeof(Slot), 1);
+    slotCount = std::bit_floor(requestedSlots);
+
+    // Free the old table first, both may not fit in memory at once
+    memory = {};
+    memory = LargePageBuffer::Allocate(slotCount * sizeof(Slot), useLargePages);
+    if (!memory.Get())
+        throw std::bad_alloc();
+    slots = static_cast<Slot*>(memory.Get());
+    generation = 0;
+}
+
+void TranspositionTable::Clear()
+{
+    ClearPart(0, 1);
+}
+
+void TranspositionTable::ClearPart(const size_t part, const size_t partCount)
+{
+    const size_t begin = slotCount * part / partCount;
+    const size_t end = slotCount * (part + 1) / partCount;
+    // Creates the slots the first time, zeroed
+    std::uninitialized_value_construct(slots + begin, slots + end);
+    if (part == 0)
+        generation = 0;
+}
+
+void TranspositionTable::NewSearch()
+{
+    generation = (generation + 1) & 0x3F;
+}
+
+bool TranspositionTable::Probe(const uint64_t key, TtEntry& entry) const
+{
+    PROFILE_SCOPE(ProfileStage::TranspositionTable);
+
+    const Slot& slot = GetSlot(key);
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.key.load(std::memory_order_relaxed) ^ data) != key || data == 0)
+    {
+        PROFILE_COUNT(ProfileCounter::TtMisses);
+        return false;
+    }
+
+    PROFILE_COUNT(ProfileCounter::TtHits);
+    entry = Unpack(data);
+    return true;
+}
+
+void TranspositionTable::Store(const uint64_t key, Move move, const int score, const int evaluation, const int depth, const Bound bound)
+{
+    PROFILE_SCOPE(ProfileStage::TranspositionTable);
+
+    Slot& slot = GetSlot(key);
+    const uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    const bool isSamePosition = (slot.key.load(std::memory_order_relaxed) ^ oldData) == key;
+    const TtEntry old = Unpack(oldData);
+
+    // Keep the deeper results of the current search unless the new one is exact
+    if (GetGeneration(oldData) == generation && bound != Bound::Exact && old.depth > depth + 2)
+        return;
+
+    if (isSamePosition && move.IsNull())
+        move = old.move;
+
+    const uint64_t data = Pack(move, score, evaluation, depth, bound, generation);
+    slot.key.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::GetHashfull() const
+{
+    const size_t sampleSize = std::min<size_t>(slotCount, 1000);
+    size_t used = 0;
+    for (size_t i = 0; i < sampleSize; i++)
+    {
+        const uint64_t data = slots[i].data.load(std::memory_order_relaxed);
+        if (data != 0 && GetGeneration(data) == generation)
+            used++;
+    }
+    return static_cast<int>(used * 1000 / sampleSize);
+}
+
+uint64_t TranspositionTable::Pack(const Move move, const int score, const int evaluation, const int depth, const Bound bound,
+    const uint8_t generation)
+{
+    return static_cast<uint64_t>(move.GetData())
+        | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16
+        | static_cast<uint64_t>(static_cast<uint16_t>(evaluation)) << 32
+        | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48
+        | static_cast<uint64_t>(bound) << 56
+        | static_cast<uint64_t>(generation) << 58;
+}
+
+TtEntry TranspositionTable::Unpack(const uint64_t data)
+{
+    TtEntry entry;
+    entry.move = Move::FromData(static_cast<uint16_t>(data));
+    entry.score = static_cast<int16_t>(data >> 16);
+    entry.evaluation = static_cast<int16_t>(data >> 32);
+    entry.depth = static_cast<uint8_t>(data >> 48);
+    entry.bound = static_cast<Bound>(data >> 56 & 3);
+    return entry;
+}
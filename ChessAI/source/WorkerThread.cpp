@@ -0,0 +1,52 @@
+﻿#include "WorkerThread.h"
+
+WorkerThread::WorkerThread()
+{
+    thread = std::thread(&WorkerThread::IdleLoop, this);
+}
+
+WorkerThread::~WorkerThread()
+{
+    {
+        std::scoped_lock lock(mutex);
+        isExiting = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void WorkerThread::StartJob(std::function<void()> newJob)
+{
+    {
+        std::scoped_lock lock(mutex);
+        job = std::move(newJob);
+    }
+    condition.notify_all();
+}
+
+void WorkerThread::WaitForJobFinished()
+{
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [this] { return !job; });
+}
+
+void WorkerThread::IdleLoop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return job || isExiting; });
+            if (isExiting)
+                return;
+        }
+
+        job();
+
+        {
+            std::scoped_lock lock(mutex);
+            job = nullptr;
+        }
+        condition.notify_all();
+    }
+}
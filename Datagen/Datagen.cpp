@@ -0,0 +1,235 @@
+﻿#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "CommandLine.h"
+#include "LargePageBuffer.h"
+#include "SelfPlay.h"
+#include "TrainingData.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage:\n"
+            << "  Datagen generate <output> [options]   Plays games against itself and writes them as game chains\n"
+            << "    --games <n>          Number of games (default: 1000)\n"
+            << "    --threads <n>        Games played in parallel (default: all hardware threads)\n"
+            << "    --nodes <n>          Nodes searched per move (default: 5000)\n"
+            << "    --random-plies <n>   Random opening moves (default: 8)\n"
+            << "    --hash <mb>          Transposition table size of each thread (default: 16)\n"
+            << "    --seed <n>           Seed of the random openings (default: 1)\n"
+            << "  Datagen convert <input> <output> [--format text|records]\n"
+            << "    text writes \"FEN | score | result\" lines readable by the tuner, records writes 32-byte packed positions\n"
+            << "  Datagen stats <input>\n";
+    }
+
+    std::string_view GetResultText(const GameResult result)
+    {
+        switch (result)
+        {
+            case GameResult::WhiteWin:
+                return "1.0";
+            case GameResult::BlackWin:
+                return "0.0";
+            default:
+                return "0.5";
+        }
+    }
+
+    int Generate(const int argc, char* argv[])
+    {
+        SelfPlaySettings settings;
+        settings.threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (int i = 3; i < argc; i++)
+        {
+            const std::string_view option = argv[i];
+            if (i + 1 >= argc)
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            const char* argument = argv[++i];
+            uint64_t value = 0;
+            if (option == "--games" && CommandLine::ParseValue(argument, 1, UINT64_MAX, value))
+                settings.games = value;
+            else if (option == "--threads" && CommandLine::ParseValue(argument, 1, CommandLine::MaxThreads, value))
+                settings.threadCount = static_cast<size_t>(value);
+            else if (option == "--nodes" && CommandLine::ParseValue(argument, 1, UINT64_MAX, value))
+                settings.nodesPerMove = value;
+            else if (option == "--random-plies" && CommandLine::ParseValue(argument, 0, static_cast<uint64_t>(settings.maxPlies), value))
+                settings.randomPlies = static_cast<int>(value);
+            else if (option == "--hash" && CommandLine::ParseValue(argument, 1, CommandLine::MaxHashMegabytes, value))
+                settings.hashMegabytes = static_cast<size_t>(value);
+            else if (option == "--seed" && CommandLine::ParseValue(argument, 0, UINT64_MAX, value))
+                settings.seed = value;
+            else
+            {
+                std::cerr << "Invalid option: " << option << ' ' << argument << '\n';
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        }
+
+        const auto printStatistics = [](const SelfPlayStatistics& statistics)
+        {
+            std::cout << "games " << statistics.games << ", positions " << statistics.positions
+                << ", " << std::fixed << std::setprecision(0) << statistics.GetPositionsPerSecond() << " positions/s"
+                << ", " << std::setprecision(2) << statistics.GetBytesPerPosition() << " bytes/position\n";
+        };
+
+        SelfPlayGenerator generator(settings);
+        std::cout << settings.threadCount << " thread(s)\nHash: " << (generator.GetHashSizeInBytes() >> 20) << " MB on "
+            << LargePageBuffer::GetName(generator.GetAllocationMode()) << ", one per thread\n";
+        if (!generator.Run(argv[2], printStatistics))
+        {
+            std::cerr << "Could not write " << argv[2] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "Done: ";
+        printStatistics(generator.GetStatistics());
+        return EXIT_SUCCESS;
+    }
+
+    int Convert(const int argc, char* argv[])
+    {
+        bool isText = true;
+        for (int i = 4; i < argc; i++)
+        {
+            const std::string_view option = argv[i];
+            if (option != "--format" || i + 1 >= argc)
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+
+            const std::string_view format = argv[++i];
+            if (format != "text" && format != "records")
+            {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+            isText = format == "text";
+        }
+
+        TrainingDataReader reader;
+        if (!reader.Open(argv[2]))
+        {
+            std::cerr << "Could not read " << argv[2] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        std::ofstream text;
+        TrainingDataWriter records;
+        if (isText)
+            text.open(argv[3]);
+        if (isText ? !text : !records.Open(argv[3], TrainingDataFormat::Records))
+        {
+            std::cerr << "Could not open " << argv[3] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        PackedPosition record;
+        Position position;
+        std::vector<uint8_t> buffer;
+        uint64_t count = 0;
+
+        while (reader.Next(record))
+        {
+            if (isText)
+            {
+                record.Unpack(position);
+                text << position.GetFen() << " | " << record.score << " | " << GetResultText(record.result) << '\n';
+            }
+            else
+            {
+                TrainingDataWriter::EncodeRecord(record, buffer);
+                if (buffer.size() >= 1 << 20)
+                {
+                    records.Write(buffer);
+                    buffer.clear();
+                }
+            }
+            count++;
+        }
+        // Failed writes leave the streams in an error state, which is only checked once at the end
+        bool isWritten;
+        if (isText)
+        {
+            text.close();
+            isWritten = !text.fail();
+        }
+        else
+        {
+            records.Write(buffer);
+            isWritten = records.Close();
+        }
+        if (!isWritten)
+        {
+            std::cerr << "Could not write " << argv[3] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Converted " << count << " positions from " << reader.GetGameCount() << " games in " << elapsed << " ms\n";
+        return EXIT_SUCCESS;
+    }
+
+    int Stats(char* argv[])
+    {
+        TrainingDataReader reader;
+        if (!reader.Open(argv[2]))
+        {
+            std::cerr << "Could not read " << argv[2] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        PackedPosition record;
+        uint64_t count = 0;
+        std::array<uint64_t, 3> results{};
+        while (reader.Next(record))
+        {
+            results[static_cast<size_t>(record.result)]++;
+            count++;
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (reader.GetFormat() == TrainingDataFormat::Chains)
+            std::cout << "Format: game chains\nGames: " << reader.GetGameCount() << '\n';
+        else
+            std::cout << "Format: records\n";
+        std::cout << "Positions: " << count << " (white wins " << results[2] << ", draws " << results[1] << ", black wins " << results[0] << ")\n"
+            << "Bytes per position: " << std::fixed << std::setprecision(2)
+            << (count ? static_cast<double>(reader.GetFileSize()) / static_cast<double>(count) : 0.0) << '\n'
+            << "Read speed: " << std::setprecision(0) << (elapsed ? static_cast<double>(count) * 1000.0 / static_cast<double>(elapsed) : 0.0)
+            << " positions/s\n";
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    const std::string_view command = argc >= 2 ? argv[1] : "";
+    if (command == "generate" && argc >= 3)
+        return Generate(argc, argv);
+    if (command == "convert" && argc >= 4)
+        return Convert(argc, argv);
+    if (command == "stats" && argc >= 3)
+        return Stats(argv);
+
+    PrintUsage();
+    return EXIT_FAILURE;
+}
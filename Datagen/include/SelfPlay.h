@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Search.h"
+#include "TrainingData.h"
+
+struct SelfPlaySettings
+{
+    size_t threadCount = 1;
+    uint64_t games = 1000;
+    uint64_t nodesPerMove = 5000;
+    // Random moves played from the start position before recording, so that the games differ
+    int randomPlies = 8;
+    size_t hashMegabytes = 16;
+    uint64_t seed = 1;
+    // The game is adjudicated as a win once the absolute score stays above this for this many plies in a row
+    int adjudicationScore = 2000;
+    int adjudicationPlies = 4;
+    int maxPlies = 400;
+};
+
+struct SelfPlayStatistics
+{
+    uint64_t games = 0;
+    uint64_t positions = 0;
+    uint64_t bytes = 0;
+    int64_t milliseconds = 0;
+
+    [[nodiscard]] double GetPositionsPerSecond() const { return milliseconds ? static_cast<double>(positions) * 1000.0 / static_cast<double>(milliseconds) : 0.0; }
+    [[nodiscard]] double GetBytesPerPosition() const { return positions ? static_cast<double>(bytes) / static_cast<double>(positions) : 0.0; }
+};
+
+// Plays games against itself with a fixed number of nodes per move, each thread owning its own search,
+// and writes them as game chains
+class SelfPlayGenerator
+{
+public:
+    // Creates the searches of the threads, so that their memory is allocated before the first game
+    explicit SelfPlayGenerator(const SelfPlaySettings& settings);
+
+    // Blocks until all the games are written. onProgress is called about once per second from the calling thread.
+    // Returns false if the file could not be opened or written, the games stop as soon as a write fails.
+    bool Run(const std::string& path, const std::function<void(const SelfPlayStatistics&)>& onProgress = {});
+
+    [[nodiscard]] SelfPlayStatistics GetStatistics() const;
+    // Of the first search, the others are allocated the same way
+    [[nodiscard]] AllocationMode GetAllocationMode() const { return searches.front()->GetAllocationMode(); }
+    [[nodiscard]] size_t GetHashSizeInBytes() const { return searches.front()->GetHashSizeInBytes(); }
+
+private:
+    void Worker(size_t index);
+    // Returns false if the game ended before a position could be recorded
+    bool PlayGame(Search& search, std::mt19937_64& random, GameRecord& game) const;
+    void Flush(std::vector<uint8_t>& buffer);
+
+    SelfPlaySettings settings;
+    // One per thread
+    std::vector<std::unique_ptr<Search>> searches;
+    TrainingDataWriter writer;
+    std::mutex writerMutex;
+    std::atomic<bool> hasWriteFailed = false;
+
+    std::atomic<uint64_t> startedGames = 0;
+    std::atomic<uint64_t> games = 0;
+    std::atomic<uint64_t> positions = 0;
+    std::atomic<uint64_t> bytes = 0;
+    std::chrono::steady_clock::time_point startTime;
+};
@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Position.h"
+
+enum class GameResult : uint8_t
+{
+    BlackWin,
+    Draw,
+    WhiteWin
+};
+
+// Fixed-size position record, stored as is in little-endian files
+struct PackedPosition
+{
+    // Bit n is set if square n holds a piece
+    uint64_t occupancy = 0;
+    // Pieces of the occupied squares in square order, two per byte, low nibble first
+    std::array<uint8_t, 16> pieces{};
+    // Search score from the point of view of the side to move
+    int16_t score = 0;
+    // Bit 0 is set if black is to move, bits 1 to 4 hold the castling rights
+    uint8_t flags = 0;
+    uint8_t enPassantSquare = NoSquare;
+    uint8_t halfmoveClock = 0;
+    GameResult result = GameResult::Draw;
+    uint16_t fullmoveNumber = 1;
+
+    [[nodiscard]] static PackedPosition Pack(const Position& position, int score, GameResult result);
+    void Unpack(Position& position) const;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+
+// A game is stored as its first recorded position followed by a chain of moves, each one encoded as its index in the
+// legal moves of the position and the difference between the score of the new position and the negated previous score
+struct GameRecord
+{
+    Position start;
+    GameResult result = GameResult::Draw;
+    std::vector<Move> moves;
+    // One score per position, scores[0] being the one of the start position
+    std::vector<int16_t> scores;
+};
+
+enum class TrainingDataFormat : uint8_t
+{
+    // Game chains written by the generator, 2 to 4 bytes per position after the first one of each game
+    Chains,
+    // One PackedPosition per position, for random access and shuffling
+    Records
+};
+
+class TrainingDataWriter
+{
+public:
+    bool Open(const std::string& path, TrainingDataFormat format);
+    // Appends already encoded data, as produced by EncodeGame or EncodeRecord. Returns false once a write failed.
+    bool Write(const std::vector<uint8_t>& data);
+    // Flushes the file, returns false if it or any previous write failed
+    bool Close();
+    [[nodiscard]] uint64_t GetBytesWritten() const { return bytesWritten; }
+
+    static void EncodeGame(const GameRecord& game, std::vector<uint8_t>& output);
+    static void EncodeRecord(const PackedPosition& record, std::vector<uint8_t>& output);
+
+private:
+    std::ofstream file;
+    uint64_t bytesWritten = 0;
+};
+
+// Reads both formats and returns the positions one by one, expanding the game chains
+class TrainingDataReader
+{
+public:
+    bool Open(const std::string& path);
+    bool Next(PackedPosition& record);
+
+    [[nodiscard]] TrainingDataFormat GetFormat() const { return format; }
+    [[nodiscard]] uint64_t GetGameCount() const { return gameCount; }
+    [[nodiscard]] uint64_t GetFileSize() const { return fileSize; }
+
+private:
+    bool ReadGameStart(PackedPosition& record);
+    bool ReadVarint(uint32_t& value);
+
+    std::ifstream file;
+    TrainingDataFormat format = TrainingDataFormat::Chains;
+    uint64_t fileSize = 0;
+    uint64_t gameCount = 0;
+
+    // State of the game being expanded
+    Position position;
+    PackedPosition current;
+    uint32_t remainingMoves = 0;
+};
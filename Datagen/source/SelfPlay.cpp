@@ -0,0 +1,171 @@
+﻿#include "SelfPlay.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+    constexpr size_t FlushThreshold = 1 << 20;
+}
+
+SelfPlayGenerator::SelfPlayGenerator(const SelfPlaySettings& settings)
+    : settings(settings)
+{
+    this->settings.threadCount = std::max<size_t>(settings.threadCount, 1);
+
+    searches.reserve(this->settings.threadCount);
+    for (size_t i = 0; i < this->settings.threadCount; i++)
+        searches.push_back(std::make_unique<Search>(this->settings.hashMegabytes, 1));
+}
+
+bool SelfPlayGenerator::Run(const std::string& path, const std::function<void(const SelfPlayStatistics&)>& onProgress)
+{
+    if (!writer.Open(path, TrainingDataFormat::Chains))
+        return false;
+
+    hasWriteFailed = false;
+    startedGames = 0;
+    games = 0;
+    positions = 0;
+    bytes = writer.GetBytesWritten();
+    startTime = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> finishedWorkers = 0;
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < settings.threadCount; i++)
+    {
+        workers.emplace_back([this, i, &finishedWorkers]
+        {
+            Worker(i);
+            finishedWorkers.fetch_add(1);
+        });
+    }
+
+    auto nextReport = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (finishedWorkers.load() < workers.size())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (onProgress && std::chrono::steady_clock::now() >= nextReport)
+        {
+            onProgress(GetStatistics());
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+    return writer.Close() && !hasWriteFailed;
+}
+
+SelfPlayStatistics SelfPlayGenerator::GetStatistics() const
+{
+    SelfPlayStatistics statistics;
+    statistics.games = games.load(std::memory_order_relaxed);
+    statistics.positions = positions.load(std::memory_order_relaxed);
+    statistics.bytes = bytes.load(std::memory_order_relaxed);
+    statistics.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    return statistics;
+}
+
+void SelfPlayGenerator::Worker(const size_t index)
+{
+    Search& search = *searches[index];
+    std::mt19937_64 random(settings.seed * 0x9E3779B97F4A7C15ull + index);
+    std::vector<uint8_t> buffer;
+    GameRecord game;
+
+    while (!hasWriteFailed.load(std::memory_order_relaxed) && startedGames.fetch_add(1, std::memory_order_relaxed) < settings.games)
+    {
+        // Retries until the random opening leaves a playable position
+        while (!PlayGame(search, random, game))
+        {
+        }
+
+        const size_t previousSize = buffer.size();
+        TrainingDataWriter::EncodeGame(game, buffer);
+        games.fetch_add(1, std::memory_order_relaxed);
+        positions.fetch_add(game.scores.size(), std::memory_order_relaxed);
+        bytes.fetch_add(buffer.size() - previousSize, std::memory_order_relaxed);
+
+        if (buffer.size() >= FlushThreshold)
+            Flush(buffer);
+    }
+
+    Flush(buffer);
+}
+
+bool SelfPlayGenerator::PlayGame(Search& search, std::mt19937_64& random, GameRecord& game) const
+{
+    Position position;
+    position.SetFen(Position::StartFen);
+    std::vector<uint64_t> history;
+    MoveList moves;
+
+    for (int ply = 0; ply < settings.randomPlies; ply++)
+    {
+        moves.Clear();
+        position.GenerateLegalMoves(moves);
+        if (moves.GetSize() == 0)
+            return false;
+
+        history.push_back(position.hash);
+        UndoInfo undo;
+        position.MakeMove(moves[random() % moves.GetSize()], undo);
+    }
+
+    search.Clear();
+    game.start = position;
+    game.moves.clear();
+    game.scores.clear();
+
+    SearchLimits limits;
+    limits.nodes = settings.nodesPerMove;
+    int decisivePlies = 0;
+
+    while (true)
+    {
+        moves.Clear();
+        position.GenerateLegalMoves(moves);
+        const bool isMate = moves.GetSize() == 0 && position.IsInCheck();
+        const bool isRepetition = std::find(history.end() - std::min<size_t>(position.halfmoveClock, history.size()), history.end(), position.hash) != history.end();
+        if (moves.GetSize() == 0 || position.halfmoveClock >= 100 || position.IsInsufficientMaterial() || isRepetition
+            || static_cast<int>(game.moves.size()) >= settings.maxPlies)
+        {
+            if (isMate)
+                game.result = position.isWhiteToMove ? GameResult::BlackWin : GameResult::WhiteWin;
+            else
+                game.result = GameResult::Draw;
+
+            // The final position has no search score, the chain ends on the position before it
+            if (game.moves.empty())
+                return false;
+            game.moves.pop_back();
+            return true;
+        }
+
+        const SearchResult result = search.Run(position, limits, history);
+        game.scores.push_back(static_cast<int16_t>(std::clamp(result.score, -32767, 32767)));
+
+        decisivePlies = std::abs(result.score) >= settings.adjudicationScore ? decisivePlies + 1 : 0;
+        if (decisivePlies >= settings.adjudicationPlies)
+        {
+            const bool isWhiteWinning = (result.score > 0) == position.isWhiteToMove;
+            game.result = isWhiteWinning ? GameResult::WhiteWin : GameResult::BlackWin;
+            return true;
+        }
+
+        game.moves.push_back(result.bestMove);
+        history.push_back(position.hash);
+        UndoInfo undo;
+        position.MakeMove(result.bestMove, undo);
+    }
+}
+
+void SelfPlayGenerator::Flush(std::vector<uint8_t>& buffer)
+{
+    const std::lock_guard lock(writerMutex);
+    if (!writer.Write(buffer))
+        hasWriteFailed = true;
+    buffer.clear();
+}
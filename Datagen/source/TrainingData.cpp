@@ -0,0 +1,201 @@
+﻿#include "TrainingData.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr std::array<char, 8> ChainsMagic = { 'C', 'A', 'I', 'G', 'A', 'M', 'E', '1' };
+    constexpr std::array<char, 8> RecordsMagic = { 'C', 'A', 'I', 'P', 'O', 'S', 'N', '1' };
+
+    constexpr uint32_t ZigZagEncode(const int32_t value) { return static_cast<uint32_t>(value) << 1 ^ static_cast<uint32_t>(value >> 31); }
+    constexpr int32_t ZigZagDecode(const uint32_t value) { return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+
+    void AppendVarint(uint32_t value, std::vector<uint8_t>& output)
+    {
+        while (value >= 0x80)
+        {
+            output.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        output.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint8_t GetMoveIndex(const Position& position, const Move move)
+    {
+        MoveList moves;
+        position.GenerateLegalMoves(moves);
+        const auto found = std::find(moves.begin(), moves.end(), move);
+        return static_cast<uint8_t>(found - moves.begin());
+    }
+}
+
+PackedPosition PackedPosition::Pack(const Position& position, const int score, const GameResult result)
+{
+    PackedPosition record;
+    size_t pieceCount = 0;
+    for (uint8_t square = 0; square < SquareCount; square++)
+    {
+        const uint8_t piece = position.board[square];
+        if (piece == NoPiece)
+            continue;
+
+        record.occupancy |= 1ull << square;
+        record.pieces[pieceCount / 2] |= static_cast<uint8_t>(piece << (pieceCount % 2 * 4));
+        pieceCount++;
+    }
+
+    record.score = static_cast<int16_t>(std::clamp(score, -32767, 32767));
+    record.flags = static_cast<uint8_t>((position.isWhiteToMove ? 0 : 1) | position.castlingRights << 1);
+    record.enPassantSquare = position.enPassantSquare;
+    record.halfmoveClock = static_cast<uint8_t>(std::min<int>(position.halfmoveClock, 255));
+    record.result = result;
+    record.fullmoveNumber = position.fullmoveNumber;
+    return record;
+}
+
+void PackedPosition::Unpack(Position& position) const
+{
+    position.Clear();
+    size_t pieceCount = 0;
+    for (uint8_t square = 0; square < SquareCount; square++)
+    {
+        if (!(occupancy >> square & 1))
+            continue;
+
+        position.AddPiece(static_cast<uint8_t>(pieces[pieceCount / 2] >> (pieceCount % 2 * 4) & 0xF), square);
+        pieceCount++;
+    }
+
+    position.isWhiteToMove = !(flags & 1);
+    position.castlingRights = flags >> 1 & 0xF;
+    position.enPassantSquare = enPassantSquare;
+    position.halfmoveClock = halfmoveClock;
+    position.fullmoveNumber = fullmoveNumber;
+    position.RefreshHash();
+}
+
+bool TrainingDataWriter::Open(const std::string& path, const TrainingDataFormat format)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    const std::array<char, 8>& magic = format == TrainingDataFormat::Chains ? ChainsMagic : RecordsMagic;
+    file.write(magic.data(), magic.size());
+    bytesWritten = magic.size();
+    return static_cast<bool>(file);
+}
+
+bool TrainingDataWriter::Write(const std::vector<uint8_t>& data)
+{
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    bytesWritten += data.size();
+    return file.good();
+}
+
+bool TrainingDataWriter::Close()
+{
+    const bool isGood = file.good();
+    file.close();
+    return isGood && !file.fail();
+}
+
+void TrainingDataWriter::EncodeGame(const GameRecord& game, std::vector<uint8_t>& output)
+{
+    EncodeRecord(PackedPosition::Pack(game.start, game.scores.front(), game.result), output);
+    AppendVarint(static_cast<uint32_t>(game.moves.size()), output);
+
+    Position position = game.start;
+    for (size_t i = 0; i < game.moves.size(); i++)
+    {
+        // Consecutive scores are seen from opposite sides, so the next one is predicted as the negated previous one
+        output.push_back(GetMoveIndex(position, game.moves[i]));
+        AppendVarint(ZigZagEncode(game.scores[i + 1] + game.scores[i]), output);
+
+        UndoInfo undo;
+        position.MakeMove(game.moves[i], undo);
+    }
+}
+
+void TrainingDataWriter::EncodeRecord(const PackedPosition& record, std::vector<uint8_t>& output)
+{
+    const size_t offset = output.size();
+    output.resize(offset + sizeof(PackedPosition));
+    std::memcpy(output.data() + offset, &record, sizeof(PackedPosition));
+}
+
+bool TrainingDataReader::Open(const std::string& path)
+{
+    file.open(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    std::array<char, 8> magic{};
+    file.read(magic.data(), magic.size());
+    if (magic == ChainsMagic)
+        format = TrainingDataFormat::Chains;
+    else if (magic == RecordsMagic)
+        format = TrainingDataFormat::Records;
+    else
+        return false;
+
+    gameCount = 0;
+    remainingMoves = 0;
+    return true;
+}
+
+bool TrainingDataReader::Next(PackedPosition& record)
+{
+    if (format == TrainingDataFormat::Records)
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&record), sizeof(PackedPosition)));
+
+    if (remainingMoves == 0)
+        return ReadGameStart(record);
+
+    const int moveIndex = file.get();
+    uint32_t delta;
+    if (moveIndex == std::char_traits<char>::eof() || !ReadVarint(delta))
+        return false;
+
+    MoveList moves;
+    position.GenerateLegalMoves(moves);
+    if (static_cast<size_t>(moveIndex) >= moves.GetSize())
+        return false;
+
+    UndoInfo undo;
+    position.MakeMove(moves[static_cast<size_t>(moveIndex)], undo);
+    current = PackedPosition::Pack(position, ZigZagDecode(delta) - current.score, current.result);
+    remainingMoves--;
+
+    record = current;
+    return true;
+}
+
+bool TrainingDataReader::ReadGameStart(PackedPosition& record)
+{
+    if (!file.read(reinterpret_cast<char*>(&current), sizeof(PackedPosition)) || !ReadVarint(remainingMoves))
+        return false;
+
+    current.Unpack(position);
+    gameCount++;
+    record = current;
+    return true;
+}
+
+bool TrainingDataReader::ReadVarint(uint32_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        const int byte = file.get();
+        if (byte == std::char_traits<char>::eof())
+            return false;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,164 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "CommandLine.h"
+#include "EpdSuite.h"
+#include "LargePageBuffer.h"
+#include "SuiteRunner.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: EpdRunner <suite.epd> [options]\n"
+            << "  --nodes <n>     Nodes searched per position\n"
+            << "  --time <ms>     Time searched per position (default: 1000 if no other limit is given)\n"
+            << "  --depth <n>     Maximum depth per position\n"
+            << "  --workers <n>   Positions searched in parallel, each by its own engine (default: all hardware threads)\n"
+            << "  --threads <n>   Search threads of each engine (default: 1)\n"
+            << "  --hash <mb>     Transposition table size of each engine (default: 16)\n"
+            << "  --json <path>   Also writes the results as JSON\n"
+            << "  --quiet         Only prints the summary\n";
+    }
+
+    void PrintDistribution(const std::string_view name, const SuiteDistribution& distribution)
+    {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+            << "mean " << std::setw(10) << distribution.mean
+            << "  min " << std::setw(9) << distribution.minimum
+            << "  median " << std::setw(9) << distribution.median
+            << "  p90 " << std::setw(9) << distribution.percentile90
+            << "  max " << std::setw(9) << distribution.maximum << '\n';
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string suitePath = argv[1];
+    SuiteSettings settings;
+    settings.workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    std::string jsonPath;
+    bool isQuiet = false;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string_view option = argv[i];
+        if (option == "--quiet")
+        {
+            isQuiet = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        const char* argument = argv[++i];
+        if (option == "--json")
+        {
+            jsonPath = argument;
+            continue;
+        }
+
+        uint64_t value = 0;
+        if (option == "--nodes" && CommandLine::ParseValue(argument, 1, UINT64_MAX, value))
+            settings.nodes = value;
+        else if (option == "--time" && CommandLine::ParseValue(argument, 1, INT64_MAX, value))
+            settings.milliseconds = static_cast<int64_t>(value);
+        else if (option == "--depth" && CommandLine::ParseValue(argument, 1, MaxDepth, value))
+            settings.depth = static_cast<int>(value);
+        else if (option == "--workers" && CommandLine::ParseValue(argument, 1, CommandLine::MaxThreads, value))
+            settings.workerCount = static_cast<size_t>(value);
+        else if (option == "--threads" && CommandLine::ParseValue(argument, 1, CommandLine::MaxThreads, value))
+            settings.threadsPerEngine = static_cast<size_t>(value);
+        else if (option == "--hash" && CommandLine::ParseValue(argument, 1, CommandLine::MaxHashMegabytes, value))
+            settings.hashMegabytes = static_cast<size_t>(value);
+        else
+        {
+            std::cerr << "Invalid option: " << option << ' ' << argument << '\n';
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (settings.nodes == 0 && settings.milliseconds == 0 && settings.depth == MaxDepth)
+        settings.milliseconds = 1000;
+
+    EpdSuite suite;
+    if (!suite.Load(suitePath))
+    {
+        std::cerr << "Cannot read " << suitePath << '\n';
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<EpdEntry>& entries = suite.GetEntries();
+    std::cout << entries.size() << " positions";
+    if (suite.GetSkippedLineCount())
+        std::cout << ", " << suite.GetSkippedLineCount() << " invalid lines skipped";
+
+    // Each worker owns an engine, extra ones would only hold memory
+    settings.workerCount = std::min(settings.workerCount, std::max<size_t>(entries.size(), 1));
+    SuiteRunner runner(settings);
+    std::cout << "\n" << settings.workerCount << " worker(s) of " << settings.threadsPerEngine << " thread(s), "
+        << settings.hashMegabytes << " MB each\n"
+        << "Hash: " << (runner.GetHashSizeInBytes() >> 20) << " MB on " << LargePageBuffer::GetName(runner.GetAllocationMode()) << "\n\n";
+
+    size_t finished = 0;
+    const SuiteResult result = runner.Run(entries, [&](const EpdEntry& entry, const SuitePositionResult& position)
+    {
+        finished++;
+        if (isQuiet)
+            return;
+
+        // No move is returned when the position has no legal moves
+        Position board;
+        board.SetFen(entry.fen);
+        const std::string move = position.move.IsNull() ? std::string("-") : board.ToSan(position.move);
+        std::cout << std::setw(5) << finished << "/" << entries.size() << "  " << std::left << std::setw(14)
+            << (entry.id.empty() ? "#" + std::to_string(position.index + 1) : entry.id)
+            << (position.isSolved ? "solved  " : "failed  ") << std::setw(8) << move << std::right
+            << (entry.bestMovesText.empty() ? " am " + entry.avoidMovesText : " bm " + entry.bestMovesText);
+        if (position.isSolved)
+            std::cout << "  (depth " << position.solutionDepth << ", " << position.solutionNodes << " nodes, " << position.solutionMilliseconds << " ms)";
+        std::cout << '\n';
+    });
+
+    const double solvedPercent = entries.empty() ? 0.0 : static_cast<double>(result.solvedCount) * 100.0 / static_cast<double>(entries.size());
+    std::cout << "\nSolved " << result.solvedCount << "/" << entries.size() << " (" << std::fixed << std::setprecision(1) << solvedPercent << "%) in "
+        << result.milliseconds << " ms, " << result.nodes << " nodes\n";
+    PrintDistribution("Time to solution (ms)", result.solutionMilliseconds);
+    PrintDistribution("Nodes to solution", result.solutionNodes);
+
+    if (result.solvedCount < entries.size())
+    {
+        std::cout << "Failed:";
+        for (const SuitePositionResult& position : result.positions)
+        {
+            if (!position.isSolved)
+                std::cout << ' ' << (entries[position.index].id.empty() ? "#" + std::to_string(position.index + 1) : entries[position.index].id);
+        }
+        std::cout << '\n';
+    }
+
+    if (!jsonPath.empty() && !SuiteRunner::WriteJson(jsonPath, std::filesystem::path(suitePath).filename().string(), settings, entries, result))
+    {
+        std::cerr << "Cannot write " << jsonPath << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Position.h"
+
+// One test position of an EPD file: the four FEN fields followed by operations such as bm Qxf7+; id "WAC.001";
+struct EpdEntry
+{
+    // Full FEN, the move counters missing from EPD are set to 0 1
+    std::string fen;
+    std::string id;
+    // Operands of bm, the position is solved by any of them
+    std::vector<Move> bestMoves;
+    // Operands of am, the position is solved by any move but these
+    std::vector<Move> avoidMoves;
+    // Operations as written in the file, for the reports
+    std::string bestMovesText;
+    std::string avoidMovesText;
+
+    [[nodiscard]] bool IsSolvedBy(Move move) const;
+};
+
+class EpdSuite
+{
+public:
+    // Lines that do not hold a legal position with at least one bm or am move are skipped
+    bool Load(const std::string& path);
+    [[nodiscard]] static bool ParseLine(std::string_view line, EpdEntry& entry);
+
+    [[nodiscard]] const std::vector<EpdEntry>& GetEntries() const { return entries; }
+    [[nodiscard]] size_t GetSkippedLineCount() const { return skippedLineCount; }
+
+private:
+    std::vector<EpdEntry> entries;
+    size_t skippedLineCount = 0;
+};
@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "EpdSuite.h"
+#include "Search.h"
+
+struct SuiteSettings
+{
+    // Independent engines, each searching its own positions
+    size_t workerCount = 1;
+    size_t threadsPerEngine = 1;
+    size_t hashMegabytes = 16;
+    // Limits of every position, zero means unlimited. The whole time is used, without the game time management.
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    int depth = MaxDepth;
+};
+
+struct SuitePositionResult
+{
+    // Index of the entry in the suite
+    size_t index = 0;
+    Move move;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    bool isSolved = false;
+    // Totals when the search settled on a solving move for good, only meaningful if solved
+    int solutionDepth = 0;
+    uint64_t solutionNodes = 0;
+    int64_t solutionMilliseconds = 0;
+};
+
+struct SuiteDistribution
+{
+    double mean = 0.0;
+    uint64_t minimum = 0;
+    uint64_t median = 0;
+    uint64_t percentile90 = 0;
+    uint64_t maximum = 0;
+
+    [[nodiscard]] static SuiteDistribution Compute(std::vector<uint64_t> values);
+};
+
+struct SuiteResult
+{
+    // In suite order
+    std::vector<SuitePositionResult> positions;
+    size_t solvedCount = 0;
+    uint64_t nodes = 0;
+    // Wall clock time of the whole run
+    int64_t milliseconds = 0;
+    // Over the solved positions only
+    SuiteDistribution solutionMilliseconds;
+    SuiteDistribution solutionNodes;
+};
+
+// Searches the positions of a suite with a pool of independent engines, so that the result of a position does not
+// depend on the ones searched before it, apart from the timing noise of the machine
+class SuiteRunner
+{
+public:
+    // Creates the engines, so that their memory is allocated before the first search
+    explicit SuiteRunner(const SuiteSettings& settings);
+
+    // onPosition is called from the worker threads, one call at a time, as soon as a position is searched
+    SuiteResult Run(const std::vector<EpdEntry>& entries, const std::function<void(const EpdEntry&, const SuitePositionResult&)>& onPosition = {});
+
+    // Machine-readable summary, for tracking regressions between versions
+    static bool WriteJson(const std::string& path, const std::string& suiteName, const SuiteSettings& settings,
+        const std::vector<EpdEntry>& entries, const SuiteResult& result);
+
+    // Of the first engine, the others are allocated the same way
+    [[nodiscard]] AllocationMode GetAllocationMode() const { return engines.front()->GetAllocationMode(); }
+    [[nodiscard]] size_t GetHashSizeInBytes() const { return engines.front()->GetHashSizeInBytes(); }
+
+private:
+    void Worker(Search& search, const std::vector<EpdEntry>& entries, std::vector<SuitePositionResult>& results,
+        const std::function<void(const EpdEntry&, const SuitePositionResult&)>& onPosition);
+    [[nodiscard]] SuitePositionResult SearchEntry(Search& search, const EpdEntry& entry) const;
+
+    SuiteSettings settings;
+    // One per worker
+    std::vector<std::unique_ptr<Search>> engines;
+    std::atomic<size_t> nextIndex = 0;
+    std::mutex callbackMutex;
+};
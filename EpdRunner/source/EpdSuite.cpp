@@ -0,0 +1,134 @@
+﻿#include "EpdSuite.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+            text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    // Splits the operations on the semicolons that are not inside a quoted operand
+    std::vector<std::string_view> SplitOperations(const std::string_view text)
+    {
+        std::vector<std::string_view> operations;
+        bool isQuoted = false;
+        size_t begin = 0;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            if (text[i] == '"')
+                isQuoted = !isQuoted;
+            else if (text[i] == ';' && !isQuoted)
+            {
+                operations.push_back(Trim(text.substr(begin, i - begin)));
+                begin = i + 1;
+            }
+        }
+        if (const std::string_view last = Trim(text.substr(begin)); !last.empty())
+            operations.push_back(last);
+        return operations;
+    }
+
+    // SAN is the norm, UCI is accepted as well since some suites are converted with engines
+    bool ParseMoves(const Position& position, const std::string_view operands, std::vector<Move>& moves)
+    {
+        std::istringstream stream{ std::string(operands) };
+        std::string token;
+        while (stream >> token)
+        {
+            Move move = position.ParseSan(token);
+            if (move.IsNull())
+                move = position.ParseUci(token);
+            if (move.IsNull())
+                return false;
+            moves.push_back(move);
+        }
+        return !moves.empty();
+    }
+}
+
+bool EpdEntry::IsSolvedBy(const Move move) const
+{
+    if (!bestMoves.empty() && std::find(bestMoves.begin(), bestMoves.end(), move) == bestMoves.end())
+        return false;
+    return std::find(avoidMoves.begin(), avoidMoves.end(), move) == avoidMoves.end();
+}
+
+bool EpdSuite::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    entries.clear();
+    skippedLineCount = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (Trim(line).empty() || Trim(line).front() == '#')
+            continue;
+
+        EpdEntry entry;
+        if (ParseLine(line, entry))
+            entries.push_back(std::move(entry));
+        else
+            skippedLineCount++;
+    }
+    return true;
+}
+
+bool EpdSuite::ParseLine(std::string_view line, EpdEntry& entry)
+{
+    // Files saved by some editors start with a byte order mark
+    if (line.starts_with("\xEF\xBB\xBF"))
+        line.remove_prefix(3);
+
+    std::istringstream stream{ std::string(line) };
+    std::string placement, side, castling, enPassant;
+    if (!(stream >> placement >> side >> castling >> enPassant))
+        return false;
+
+    entry = {};
+    entry.fen = placement + ' ' + side + ' ' + castling + ' ' + enPassant + " 0 1";
+    Position position;
+    if (!position.SetFen(entry.fen))
+        return false;
+
+    std::string operationsText;
+    std::getline(stream, operationsText);
+    for (const std::string_view operation : SplitOperations(operationsText))
+    {
+        const size_t space = operation.find_first_of(" \t");
+        const std::string_view opcode = operation.substr(0, space);
+        const std::string_view operands = space == std::string_view::npos ? std::string_view() : Trim(operation.substr(space));
+
+        if (opcode == "bm")
+        {
+            if (!ParseMoves(position, operands, entry.bestMoves))
+                return false;
+            entry.bestMovesText = operands;
+        }
+        else if (opcode == "am")
+        {
+            if (!ParseMoves(position, operands, entry.avoidMoves))
+                return false;
+            entry.avoidMovesText = operands;
+        }
+        else if (opcode == "id")
+        {
+            entry.id = operands;
+            if (entry.id.size() >= 2 && entry.id.front() == '"' && entry.id.back() == '"')
+                entry.id = entry.id.substr(1, entry.id.size() - 2);
+        }
+    }
+
+    return !entry.bestMoves.empty() || !entry.avoidMoves.empty();
+}
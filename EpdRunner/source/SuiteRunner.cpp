@@ -0,0 +1,189 @@
+﻿#include "SuiteRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <thread>
+
+#include "Json.h"
+
+namespace
+{
+    void WriteDistribution(std::ofstream& file, const SuiteDistribution& distribution)
+    {
+        file << "{ \"mean\": " << distribution.mean << ", \"min\": " << distribution.minimum << ", \"median\": " << distribution.median
+            << ", \"p90\": " << distribution.percentile90 << ", \"max\": " << distribution.maximum << " }";
+    }
+}
+
+SuiteDistribution SuiteDistribution::Compute(std::vector<uint64_t> values)
+{
+    SuiteDistribution distribution;
+    if (values.empty())
+        return distribution;
+
+    std::sort(values.begin(), values.end());
+    distribution.mean = static_cast<double>(std::accumulate(values.begin(), values.end(), uint64_t{ 0 })) / static_cast<double>(values.size());
+    distribution.minimum = values.front();
+    distribution.median = values[(values.size() - 1) / 2];
+    distribution.percentile90 = values[(values.size() - 1) * 9 / 10];
+    distribution.maximum = values.back();
+    return distribution;
+}
+
+SuiteRunner::SuiteRunner(const SuiteSettings& settings)
+    : settings(settings)
+{
+    this->settings.workerCount = std::max<size_t>(settings.workerCount, 1);
+    this->settings.threadsPerEngine = std::max<size_t>(settings.threadsPerEngine, 1);
+
+    engines.reserve(this->settings.workerCount);
+    for (size_t i = 0; i < this->settings.workerCount; i++)
+        engines.push_back(std::make_unique<Search>(this->settings.hashMegabytes, this->settings.threadsPerEngine));
+}
+
+SuiteResult SuiteRunner::Run(const std::vector<EpdEntry>& entries, const std::function<void(const EpdEntry&, const SuitePositionResult&)>& onPosition)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    nextIndex = 0;
+
+    SuiteResult result;
+    result.positions.resize(entries.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(settings.workerCount, entries.size()); i++)
+        workers.emplace_back(&SuiteRunner::Worker, this, std::ref(*engines[i]), std::cref(entries), std::ref(result.positions), std::cref(onPosition));
+    for (std::thread& worker : workers)
+        worker.join();
+
+    std::vector<uint64_t> solutionMilliseconds, solutionNodes;
+    for (const SuitePositionResult& position : result.positions)
+    {
+        result.nodes += position.nodes;
+        if (!position.isSolved)
+            continue;
+        result.solvedCount++;
+        solutionMilliseconds.push_back(static_cast<uint64_t>(position.solutionMilliseconds));
+        solutionNodes.push_back(position.solutionNodes);
+    }
+    result.solutionMilliseconds = SuiteDistribution::Compute(std::move(solutionMilliseconds));
+    result.solutionNodes = SuiteDistribution::Compute(std::move(solutionNodes));
+    result.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+void SuiteRunner::Worker(Search& search, const std::vector<EpdEntry>& entries, std::vector<SuitePositionResult>& results,
+    const std::function<void(const EpdEntry&, const SuitePositionResult&)>& onPosition)
+{
+    for (size_t index = nextIndex.fetch_add(1); index < entries.size(); index = nextIndex.fetch_add(1))
+    {
+        // Each worker only writes the results of the positions it took
+        results[index] = SearchEntry(search, entries[index]);
+        results[index].index = index;
+
+        if (onPosition)
+        {
+            std::scoped_lock lock(callbackMutex);
+            onPosition(entries[index], results[index]);
+        }
+    }
+}
+
+SuitePositionResult SuiteRunner::SearchEntry(Search& search, const EpdEntry& entry) const
+{
+    Position position;
+    position.SetFen(entry.fen);
+    search.Clear();
+
+    SuitePositionResult result;
+    // The solution is the first iteration of the last run of iterations that all found a solving move
+    bool isSolving = false;
+    search.onIteration = [&entry, &result, &isSolving](const SearchIteration& iteration)
+    {
+        const bool solves = !iteration.pv.empty() && entry.IsSolvedBy(iteration.pv.front());
+        if (solves && !isSolving)
+        {
+            result.solutionDepth = iteration.depth;
+            result.solutionNodes = iteration.nodes;
+            result.solutionMilliseconds = iteration.milliseconds;
+        }
+        isSolving = solves;
+    };
+
+    SearchLimits limits;
+    limits.depth = settings.depth;
+    limits.nodes = settings.nodes;
+    if (settings.milliseconds)
+    {
+        // The search limit would stop at the last iteration expected to finish in time, a suite uses the whole budget
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(settings.milliseconds);
+        limits.stopCondition = [deadline] { return std::chrono::steady_clock::now() >= deadline; };
+    }
+
+    const SearchResult searchResult = search.Run(position, limits);
+    search.onIteration = nullptr;
+
+    result.move = searchResult.bestMove;
+    result.score = searchResult.score;
+    result.depth = searchResult.depth;
+    result.nodes = searchResult.nodes;
+    result.milliseconds = searchResult.milliseconds;
+    result.isSolved = !result.move.IsNull() && entry.IsSolvedBy(result.move);
+
+    // Stopped before the first iteration completed
+    if (result.isSolved && !isSolving)
+    {
+        result.solutionDepth = result.depth;
+        result.solutionNodes = result.nodes;
+        result.solutionMilliseconds = result.milliseconds;
+    }
+    return result;
+}
+
+bool SuiteRunner::WriteJson(const std::string& path, const std::string& suiteName, const SuiteSettings& settings,
+    const std::vector<EpdEntry>& entries, const SuiteResult& result)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        return false;
+
+    file << std::fixed << std::setprecision(1);
+    file << "{\n"
+        << "  \"suite\": \"" << Json::Escape(suiteName) << "\",\n"
+        << "  \"settings\": { \"nodes\": " << settings.nodes << ", \"milliseconds\": " << settings.milliseconds
+        << ", \"depth\": " << settings.depth << ", \"workers\": " << settings.workerCount
+        << ", \"threads\": " << settings.threadsPerEngine << ", \"hash\": " << settings.hashMegabytes << " },\n"
+        << "  \"positions\": " << entries.size() << ",\n"
+        << "  \"solved\": " << result.solvedCount << ",\n"
+        << "  \"nodes\": " << result.nodes << ",\n"
+        << "  \"milliseconds\": " << result.milliseconds << ",\n"
+        << "  \"solutionMilliseconds\": ";
+    WriteDistribution(file, result.solutionMilliseconds);
+    file << ",\n  \"solutionNodes\": ";
+    WriteDistribution(file, result.solutionNodes);
+    file << ",\n  \"results\": [\n";
+
+    for (size_t i = 0; i < result.positions.size(); i++)
+    {
+        const SuitePositionResult& position = result.positions[i];
+        const EpdEntry& entry = entries[position.index];
+        Position board;
+        board.SetFen(entry.fen);
+
+        file << "    { \"id\": \"" << Json::Escape(entry.id) << "\", \"bm\": \"" << Json::Escape(entry.bestMovesText)
+            << "\", \"am\": \"" << Json::Escape(entry.avoidMovesText) << "\", \"move\": \""
+            << (position.move.IsNull() ? std::string() : board.ToSan(position.move)) << "\", \"solved\": " << (position.isSolved ? "true" : "false")
+            << ", \"score\": " << position.score << ", \"depth\": " << position.depth << ", \"nodes\": " << position.nodes
+            << ", \"milliseconds\": " << position.milliseconds;
+        if (position.isSolved)
+        {
+            file << ", \"solutionDepth\": " << position.solutionDepth << ", \"solutionNodes\": " << position.solutionNodes
+                << ", \"solutionMilliseconds\": " << position.solutionMilliseconds;
+        }
+        file << " }" << (i + 1 < result.positions.size() ? "," : "") << '\n';
+    }
+
+    file << "  ]\n}\n";
+    return static_cast<bool>(file);
+}
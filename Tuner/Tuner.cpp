@@ -0,0 +1,105 @@
+﻿#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "TexelTuner.h"
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: Tuner <positions> [options]\n"
+            << "  --output <path>   Generated header, copy it to ChessAI/include (default: EvaluationParameters.h)\n"
+            << "  --threads <n>     Worker threads (default: all hardware threads)\n"
+            << "  --epochs <n>      Optimizer iterations over the whole data set (default: 2000)\n"
+            << "  --rate <r>        Adam learning rate, in centipawns (default: 1)\n"
+            << "  --limit <n>       Maximum number of positions to load (default: all)\n"
+            << "  --scaling <k>     Sigmoid scaling constant, fitted to the data when omitted\n";
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string positionsPath = argv[1];
+    std::string outputPath = "EvaluationParameters.h";
+    size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    int epochs = 2000;
+    double learningRate = 1.0;
+    size_t limit = 0;
+    double scalingConstant = 0.0;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string_view option = argv[i];
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        const char* value = argv[++i];
+        if (option == "--output")
+            outputPath = value;
+        else if (option == "--threads")
+            threadCount = std::strtoull(value, nullptr, 10);
+        else if (option == "--epochs")
+            epochs = std::atoi(value);
+        else if (option == "--rate")
+            learningRate = std::atof(value);
+        else if (option == "--limit")
+            limit = std::strtoull(value, nullptr, 10);
+        else if (option == "--scaling")
+            scalingConstant = std::atof(value);
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    TexelTuner tuner(threadCount);
+    const size_t positionCount = tuner.LoadPositions(positionsPath, limit);
+    if (positionCount == 0)
+    {
+        std::cerr << "No positions could be loaded from " << positionsPath << '\n';
+        return EXIT_FAILURE;
+    }
+    std::cout << "Loaded " << positionCount << " positions, " << tuner.GetFeatureCount() << " features ("
+        << static_cast<double>(tuner.GetFeatureCount()) / static_cast<double>(positionCount) << " per position)\n";
+
+    if (scalingConstant > 0.0)
+        tuner.SetScalingConstant(scalingConstant);
+    else
+        scalingConstant = tuner.FitScalingConstant();
+    std::cout << "Scaling constant " << scalingConstant << ", initial loss " << tuner.ComputeLoss() << '\n';
+
+    tuner.Run(epochs, learningRate, [&](const TunerEpoch& epoch)
+    {
+        if (epoch.epoch % 50 == 0 || epoch.epoch == 1)
+        {
+            std::cout << "Epoch " << epoch.epoch << ": loss " << epoch.loss << ", " << epoch.milliseconds << " ms ("
+                << static_cast<double>(epoch.milliseconds) / epoch.epoch << " ms per epoch)\n";
+        }
+        // Saves regularly so that a long run can be interrupted
+        if (epoch.epoch % 500 == 0)
+            tuner.WriteParameters(outputPath);
+    });
+
+    std::cout << "Final loss " << tuner.ComputeLoss() << '\n';
+    if (!tuner.WriteParameters(outputPath))
+    {
+        std::cerr << "Could not write " << outputPath << '\n';
+        return EXIT_FAILURE;
+    }
+    std::cout << "Parameters written to " << outputPath << '\n';
+    return EXIT_SUCCESS;
+}
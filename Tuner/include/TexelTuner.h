@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Evaluation.h"
+#include "WorkerThread.h"
+
+struct TunerEpoch
+{
+    int epoch = 0;
+    double loss = 0.0;
+    int64_t milliseconds = 0;
+};
+
+// Fits the evaluation parameters to game results by minimizing the mean squared error between the results and
+// a sigmoid of the evaluation (Texel's tuning method). The evaluation is linear in its parameters, so each position
+// is reduced to its feature coefficients once when loaded, and never evaluated again.
+class TexelTuner
+{
+public:
+    explicit TexelTuner(size_t threadCount);
+
+    // Each line holds a FEN followed by the result of the game from white's point of view, either as 1-0, 0-1 and 1/2-1/2
+    // or as 1.0, 0.0 and 0.5, optionally between brackets or after a '|' separator. Returns the number of positions loaded.
+    size_t LoadPositions(const std::string& path, size_t limit = 0);
+
+    // Finds the constant scaling evaluations into the sigmoid that best fits the current parameters
+    double FitScalingConstant();
+    void SetScalingConstant(double constant) { scalingConstant = constant; }
+
+    // Adam optimizer on the full data set, the loss and gradient are computed by all threads
+    void Run(int epochs, double learningRate, const std::function<void(const TunerEpoch&)>& onEpoch = {});
+
+    [[nodiscard]] double ComputeLoss() const;
+    // Writes the rounded parameters as a header that replaces include/EvaluationParameters.h
+    bool WriteParameters(const std::string& path) const;
+
+    [[nodiscard]] size_t GetPositionCount() const { return results.size(); }
+    [[nodiscard]] size_t GetFeatureCount() const { return featureIndices.size(); }
+
+private:
+    // Returns the loss, and accumulates the gradient of the weights if gradient is not null
+    double Compute(std::vector<double>* gradient) const;
+    void ParallelFor(size_t count, const std::function<void(size_t thread, size_t begin, size_t end)>& job) const;
+
+    size_t threadCount;
+    // Created once for the whole run. The first chunk of every ParallelFor runs in the calling thread, the others on these workers.
+    std::vector<std::unique_ptr<WorkerThread>> workers;
+    double scalingConstant = 1.0;
+
+    // Positions are stored as structures of arrays. The features of position i are the pairs of
+    // featureIndices and featureCounts in [featureOffsets[i], featureOffsets[i + 1]).
+    std::vector<uint64_t> featureOffsets{ 0 };
+    std::vector<uint16_t> featureIndices;
+    // Mobility coefficients sum the moves of all pieces of a type and do not fit in 8 bits
+    std::vector<int16_t> featureCounts;
+    std::vector<float> results;
+    // Phase / MaxPhase, the share of the middle game weights in the evaluation
+    std::vector<float> middleGameRatios;
+    // Tempo bonus from white's point of view
+    std::vector<float> offsets;
+
+    // Middle game and end game weights are interleaved: weights[2 * parameter] and weights[2 * parameter + 1]
+    std::vector<double> weights;
+};
@@ -0,0 +1,398 @@
+﻿#include "TexelTuner.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string_view>
+
+#include "EvaluationParameters.h"
+#include "Position.h"
+
+namespace
+{
+    struct Section
+    {
+        size_t offset;
+        size_t count;
+        size_t rowLength;
+        std::string_view title;
+    };
+
+    constexpr std::array Sections = {
+        Section{ MaterialOffset, 6, 6, "Material" },
+        Section{ PieceSquareOffset + 0 * SquareCount, SquareCount, 8, "King piece-square table" },
+        Section{ PieceSquareOffset + 1 * SquareCount, SquareCount, 8, "Queen piece-square table" },
+        Section{ PieceSquareOffset + 2 * SquareCount, SquareCount, 8, "Rook piece-square table" },
+        Section{ PieceSquareOffset + 3 * SquareCount, SquareCount, 8, "Bishop piece-square table" },
+        Section{ PieceSquareOffset + 4 * SquareCount, SquareCount, 8, "Knight piece-square table" },
+        Section{ PieceSquareOffset + 5 * SquareCount, SquareCount, 8, "Pawn piece-square table" },
+        Section{ PassedPawnOffset, 8, 8, "Passed pawns by rank" },
+        Section{ DoubledPawnIndex, 5, 5, "Doubled pawn, isolated pawn, bishop pair, rook on open file, rook on semi-open file" },
+        Section{ MobilityOffset, 6, 6, "Mobility" }
+    };
+
+    // Positions parsed by one thread, appended to the tuner's arrays once the chunk is done
+    struct LoadedPositions
+    {
+        std::vector<uint32_t> featureCounts;
+        std::vector<uint16_t> indices;
+        std::vector<int16_t> counts;
+        std::vector<float> results;
+        std::vector<float> middleGameRatios;
+        std::vector<float> offsets;
+    };
+
+    std::string_view Trim(std::string_view text)
+    {
+        constexpr std::string_view Ignored = " \t\r\n\"';[]";
+        const size_t begin = text.find_first_not_of(Ignored);
+        if (begin == std::string_view::npos)
+            return {};
+        return text.substr(begin, text.find_last_not_of(Ignored) - begin + 1);
+    }
+
+    bool ParseResult(const std::string_view text, float& result)
+    {
+        if (text == "1-0" || text == "1.0" || text == "1")
+            result = 1.0f;
+        else if (text == "0-1" || text == "0.0" || text == "0")
+            result = 0.0f;
+        else if (text == "1/2-1/2" || text == "0.5")
+            result = 0.5f;
+        else
+            return false;
+        return true;
+    }
+
+    bool ParseLine(std::string_view line, Position& position, float& result)
+    {
+        size_t fenEnd;
+        std::string_view resultText;
+        if (const size_t bracket = line.find('['); bracket != std::string_view::npos)
+        {
+            fenEnd = bracket;
+            resultText = line.substr(bracket, line.find(']', bracket) - bracket);
+        }
+        else if (const size_t separator = line.find('|'); separator != std::string_view::npos)
+        {
+            fenEnd = separator;
+            resultText = line.substr(line.rfind('|') + 1);
+        }
+        else
+        {
+            line = Trim(line);
+            fenEnd = line.rfind(' ');
+            if (fenEnd == std::string_view::npos)
+                return false;
+            resultText = line.substr(fenEnd + 1);
+        }
+
+        // The FEN parser ignores anything after the fields it reads, such as EPD opcodes
+        return ParseResult(Trim(resultText), result) && position.SetFen(line.substr(0, fenEnd));
+    }
+}
+
+TexelTuner::TexelTuner(const size_t threadCount)
+    : threadCount(std::max<size_t>(threadCount, 1))
+{
+    workers.reserve(this->threadCount - 1);
+    for (size_t thread = 1; thread < this->threadCount; thread++)
+        workers.push_back(std::make_unique<WorkerThread>());
+
+    weights.resize(2 * EvaluationParameterCount);
+    for (size_t parameter = 0; parameter < EvaluationParameterCount; parameter++)
+    {
+        weights[2 * parameter] = TunedParameters[parameter].middleGame;
+        weights[2 * parameter + 1] = TunedParameters[parameter].endGame;
+    }
+}
+
+size_t TexelTuner::LoadPositions(const std::string& path, const size_t limit)
+{
+    std::ifstream file(path);
+    if (!file)
+        return 0;
+
+    constexpr size_t ChunkSize = 1 << 16;
+    std::vector<std::string> lines;
+    lines.reserve(ChunkSize);
+    const size_t initialCount = GetPositionCount();
+
+    while (true)
+    {
+        lines.clear();
+        std::string line;
+        while (lines.size() < ChunkSize && (limit == 0 || GetPositionCount() - initialCount + lines.size() < limit) && std::getline(file, line))
+            lines.push_back(std::move(line));
+        if (lines.empty())
+            break;
+
+        std::vector<LoadedPositions> chunks(threadCount);
+        ParallelFor(lines.size(), [&](const size_t thread, const size_t begin, const size_t end)
+        {
+            LoadedPositions& chunk = chunks[thread];
+            Position position;
+            EvaluationTrace trace;
+            for (size_t i = begin; i < end; i++)
+            {
+                float result;
+                if (!ParseLine(lines[i], position, result))
+                    continue;
+
+                Evaluation::Trace(position, trace);
+                uint32_t featureCount = 0;
+                for (size_t parameter = 0; parameter < EvaluationParameterCount; parameter++)
+                {
+                    const int coefficient = trace.coefficients[parameter];
+                    if (coefficient == 0)
+                        continue;
+                    chunk.indices.push_back(static_cast<uint16_t>(parameter));
+                    chunk.counts.push_back(static_cast<int16_t>(coefficient));
+                    featureCount++;
+                }
+
+                chunk.featureCounts.push_back(featureCount);
+                chunk.results.push_back(result);
+                chunk.middleGameRatios.push_back(static_cast<float>(trace.phase) / Evaluation::MaxPhase);
+                chunk.offsets.push_back(static_cast<float>(position.isWhiteToMove ? Evaluation::Tempo : -Evaluation::Tempo));
+            }
+        });
+
+        // Appending in thread order keeps the positions in file order
+        for (const LoadedPositions& chunk : chunks)
+        {
+            for (const uint32_t featureCount : chunk.featureCounts)
+                featureOffsets.push_back(featureOffsets.back() + featureCount);
+            featureIndices.insert(featureIndices.end(), chunk.indices.begin(), chunk.indices.end());
+            featureCounts.insert(featureCounts.end(), chunk.counts.begin(), chunk.counts.end());
+            results.insert(results.end(), chunk.results.begin(), chunk.results.end());
+            middleGameRatios.insert(middleGameRatios.end(), chunk.middleGameRatios.begin(), chunk.middleGameRatios.end());
+            offsets.insert(offsets.end(), chunk.offsets.begin(), chunk.offsets.end());
+        }
+    }
+
+    return GetPositionCount() - initialCount;
+}
+
+double TexelTuner::FitScalingConstant()
+{
+    // The loss is unimodal in the constant, a golden section search converges quickly
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = 0.0;
+    double high = 4.0;
+
+    const auto lossAt = [this](const double constant)
+    {
+        scalingConstant = constant;
+        return ComputeLoss();
+    };
+
+    double left = high - ratio * (high - low);
+    double right = low + ratio * (high - low);
+    double leftLoss = lossAt(left);
+    double rightLoss = lossAt(right);
+    for (int iteration = 0; iteration < 40; iteration++)
+    {
+        if (leftLoss < rightLoss)
+        {
+            high = right;
+            right = left;
+            rightLoss = leftLoss;
+            left = high - ratio * (high - low);
+            leftLoss = lossAt(left);
+        }
+        else
+        {
+            low = left;
+            left = right;
+            leftLoss = rightLoss;
+            right = low + ratio * (high - low);
+            rightLoss = lossAt(right);
+        }
+    }
+
+    scalingConstant = (low + high) / 2.0;
+    return scalingConstant;
+}
+
+void TexelTuner::Run(const int epochs, const double learningRate, const std::function<void(const TunerEpoch&)>& onEpoch)
+{
+    constexpr double Beta1 = 0.9;
+    constexpr double Beta2 = 0.999;
+    constexpr double Epsilon = 1e-8;
+
+    std::vector<double> gradient;
+    std::vector<double> momentum(weights.size());
+    std::vector<double> velocity(weights.size());
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for (int epoch = 1; epoch <= epochs; epoch++)
+    {
+        const double loss = Compute(&gradient);
+
+        const double momentumCorrection = 1.0 - std::pow(Beta1, epoch);
+        const double velocityCorrection = 1.0 - std::pow(Beta2, epoch);
+        for (size_t i = 0; i < weights.size(); i++)
+        {
+            momentum[i] = Beta1 * momentum[i] + (1.0 - Beta1) * gradient[i];
+            velocity[i] = Beta2 * velocity[i] + (1.0 - Beta2) * gradient[i] * gradient[i];
+            weights[i] -= learningRate * (momentum[i] / momentumCorrection) / (std::sqrt(velocity[i] / velocityCorrection) + Epsilon);
+        }
+
+        if (onEpoch)
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+            onEpoch({ epoch, loss, elapsed.count() });
+        }
+    }
+}
+
+double TexelTuner::ComputeLoss() const
+{
+    return Compute(nullptr);
+}
+
+bool TexelTuner::WriteParameters(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    file << "\xEF\xBB\xBF#pragma once\n\n"
+        << "// Generated by the Tuner project from labelled positions, do not edit by hand\n\n"
+        << "#include \"Evaluation.h\"\n\n"
+        << "constexpr EvaluationParameters TunedParameters = {{\n";
+
+    for (size_t section = 0; section < Sections.size(); section++)
+    {
+        const Section& current = Sections[section];
+        file << (section == 0 ? "" : "\n") << "    // " << current.title << '\n';
+
+        for (size_t i = 0; i < current.count; i++)
+        {
+            const size_t parameter = current.offset + i;
+            const bool isLast = parameter == EvaluationParameterCount - 1;
+            file << (i % current.rowLength == 0 ? "    " : " ")
+                << "{ " << std::lround(weights[2 * parameter]) << ", " << std::lround(weights[2 * parameter + 1]) << " }"
+                << (isLast ? "" : ",");
+            if (i % current.rowLength == current.rowLength - 1 || i == current.count - 1)
+                file << '\n';
+        }
+    }
+
+    file << "}};\n";
+    return static_cast<bool>(file);
+}
+
+double TexelTuner::Compute(std::vector<double>* gradient) const
+{
+    constexpr size_t BlockSize = 256;
+    const size_t positionCount = GetPositionCount();
+    if (positionCount == 0)
+        return 0.0;
+
+    // The derivative of the sigmoid 1 / (1 + 10^(-k * e / 400)) with respect to e is s * (1 - s) * k * ln(10) / 400
+    const double scale = scalingConstant * std::log(10.0) / 400.0;
+    std::vector<double> losses(threadCount);
+    std::vector<std::vector<double>> gradients(gradient ? threadCount : 0);
+
+    ParallelFor(positionCount, [&](const size_t thread, const size_t begin, const size_t end)
+    {
+        std::vector<double>* localGradient = gradient ? &gradients[thread] : nullptr;
+        if (localGradient)
+            localGradient->assign(weights.size(), 0.0);
+
+        std::array<double, BlockSize> evaluations;
+        std::array<double, BlockSize> errors;
+        double loss = 0.0;
+
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BlockSize)
+        {
+            const size_t blockSize = std::min(BlockSize, end - blockBegin);
+
+            // Sparse dot products of the features with the weights
+            for (size_t i = 0; i < blockSize; i++)
+            {
+                const size_t position = blockBegin + i;
+                double middleGame = 0.0;
+                double endGame = 0.0;
+                for (uint64_t feature = featureOffsets[position]; feature < featureOffsets[position + 1]; feature++)
+                {
+                    const double count = featureCounts[feature];
+                    const size_t weight = 2 * static_cast<size_t>(featureIndices[feature]);
+                    middleGame += count * weights[weight];
+                    endGame += count * weights[weight + 1];
+                }
+                const double ratio = middleGameRatios[position];
+                evaluations[i] = middleGame * ratio + endGame * (1.0 - ratio) + offsets[position];
+            }
+
+            // Dense pass over contiguous arrays, without any indirection so that the compiler can vectorize it
+            const float* blockResults = results.data() + blockBegin;
+            for (size_t i = 0; i < blockSize; i++)
+            {
+                const double sigmoid = 1.0 / (1.0 + std::exp(-scale * evaluations[i]));
+                const double error = sigmoid - blockResults[i];
+                evaluations[i] = error * error;
+                errors[i] = error * sigmoid * (1.0 - sigmoid);
+            }
+            for (size_t i = 0; i < blockSize; i++)
+                loss += evaluations[i];
+
+            if (!localGradient)
+                continue;
+
+            for (size_t i = 0; i < blockSize; i++)
+            {
+                const size_t position = blockBegin + i;
+                const double middleGameError = errors[i] * middleGameRatios[position];
+                const double endGameError = errors[i] - middleGameError;
+                for (uint64_t feature = featureOffsets[position]; feature < featureOffsets[position + 1]; feature++)
+                {
+                    const double count = featureCounts[feature];
+                    const size_t weight = 2 * static_cast<size_t>(featureIndices[feature]);
+                    (*localGradient)[weight] += middleGameError * count;
+                    (*localGradient)[weight + 1] += endGameError * count;
+                }
+            }
+        }
+
+        losses[thread] = loss;
+    });
+
+    if (gradient)
+    {
+        gradient->assign(weights.size(), 0.0);
+        const double factor = 2.0 * scale / static_cast<double>(positionCount);
+        for (const std::vector<double>& localGradient : gradients)
+        {
+            if (localGradient.empty())
+                continue;
+            for (size_t i = 0; i < weights.size(); i++)
+                (*gradient)[i] += localGradient[i] * factor;
+        }
+    }
+
+    double loss = 0.0;
+    for (const double threadLoss : losses)
+        loss += threadLoss;
+    return loss / static_cast<double>(positionCount);
+}
+
+void TexelTuner::ParallelFor(const size_t count, const std::function<void(size_t thread, size_t begin, size_t end)>& job) const
+{
+    const size_t chunkSize = (count + threadCount - 1) / threadCount;
+    for (size_t thread = 1; thread < threadCount; thread++)
+    {
+        const size_t begin = std::min(thread * chunkSize, count);
+        const size_t end = std::min(begin + chunkSize, count);
+        workers[thread - 1]->StartJob([&job, thread, begin, end] { job(thread, begin, end); });
+    }
+
+    job(0, 0, std::min(chunkSize, count));
+
+    for (const std::unique_ptr<WorkerThread>& worker : workers)
+        worker->WaitForJobFinished();
+}